@@ -31,7 +31,7 @@ void AP_Periph_FW::can_proximity_update()
 
     ardupilot_equipment_proximity_sensor_Proximity pkt {};
 
-    const uint8_t obstacle_count = proximity.get_obstacle_count();
+    const uint16_t obstacle_count = proximity.get_obstacle_count();
 
     // if no objects return
     if (obstacle_count == 0) {
@@ -39,7 +39,7 @@ void AP_Periph_FW::can_proximity_update()
     }
 
     // calculate maximum roll, pitch values from objects
-    for (uint8_t i=0; i<obstacle_count; i++) {
+    for (uint16_t i=proximity.get_next_obstacle(0); i<obstacle_count; i=proximity.get_next_obstacle(i+1)) {
         if (!proximity.get_obstacle_info(i, pkt.yaw, pkt.pitch, pkt.distance)) {
             // not a valid obstacle
             continue;
@@ -1,5 +1,6 @@
 #include "DataFlashFileReader.h"
 #include <AP_Filesystem/AP_Filesystem.h>
+#include <AP_Logger/AP_Logger_Compress.h>
 
 #include <fcntl.h>
 #include <string.h>
@@ -10,6 +11,10 @@
 #include <time.h>
 #include <cinttypes>
 
+#if AP_LOGREADER_MMAP_ENABLED
+#include <sys/mman.h>
+#endif
+
 #ifndef PRIu64
 #define PRIu64 "llu"
 #endif
@@ -20,10 +25,117 @@ AP_LoggerFileReader::AP_LoggerFileReader()
 AP_LoggerFileReader::~AP_LoggerFileReader()
 {
     ::printf("Replay counts: %" PRIu64 " bytes  %u entries\n", bytes_read, message_count);
+#if AP_LOGREADER_MMAP_ENABLED
+#if AP_LOGGER_COMPRESSION_ENABLED
+    if (mapped_log_on_heap) {
+        free(mapped_log);
+        mapped_log = nullptr;
+    }
+#endif
+    if (mapped_log != nullptr) {
+        munmap(mapped_log, file_size);
+    }
+#endif
+}
+
+#if AP_LOGREADER_MMAP_ENABLED
+/*
+  map the whole log into memory. This avoids a read() call and a copy
+  for every message, and lets the kernel read ahead on large logs
+ */
+bool AP_LoggerFileReader::map_log(const char *logfile)
+{
+    const int mfd = ::open(logfile, O_RDONLY|O_CLOEXEC);
+    if (mfd == -1) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(mfd, &st) != 0 || st.st_size <= 0) {
+        ::close(mfd);
+        return false;
+    }
+    // private writable mapping so message handlers may modify the
+    // message bytes in place without touching the file
+    void *ptr = mmap(nullptr, st.st_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, mfd, 0);
+    ::close(mfd);
+    if (ptr == MAP_FAILED) {
+        return false;
+    }
+    madvise(ptr, st.st_size, MADV_SEQUENTIAL);
+#if AP_LOGGER_COMPRESSION_ENABLED
+    if (AP_Logger_Compress::is_compressed((const uint8_t *)ptr, st.st_size)) {
+        const bool ret = decompress_log((const uint8_t *)ptr, st.st_size);
+        munmap(ptr, st.st_size);
+        return ret;
+    }
+#endif
+    mapped_log = (uint8_t *)ptr;
+    file_size = st.st_size;
+    return true;
+}
+
+#if AP_LOGGER_COMPRESSION_ENABLED
+/*
+  decompress a whole compressed log into memory. A truncated or
+  corrupt final frame ends the log, as it would for an uncompressed
+  log cut short
+ */
+bool AP_LoggerFileReader::decompress_log(const uint8_t *data, uint64_t len)
+{
+    // a trailer marks where the frames end
+    AP_Logger_Compress::block_trailer trailer;
+    if (len >= sizeof(trailer) && len <= UINT32_MAX) {
+        memcpy(&trailer, &data[len-sizeof(trailer)], sizeof(trailer));
+        if (AP_Logger_Compress::valid_trailer(trailer, len)) {
+            len = trailer.comp_size;
+        }
+    }
+
+    // first pass finds the uncompressed size
+    AP_Logger_Compress::block_header hdr;
+    uint64_t ofs = 0;
+    uint64_t raw_size = 0;
+    while (ofs + sizeof(hdr) <= len) {
+        memcpy(&hdr, &data[ofs], sizeof(hdr));
+        if (!AP_Logger_Compress::valid_header(hdr) || ofs + sizeof(hdr) + hdr.comp_len > len) {
+            break;
+        }
+        raw_size += hdr.raw_len;
+        ofs += sizeof(hdr) + hdr.comp_len;
+    }
+    if (raw_size == 0) {
+        return false;
+    }
+    uint8_t *buf = (uint8_t *)malloc(raw_size);
+    if (buf == nullptr) {
+        return false;
+    }
+    const uint64_t end = ofs;
+    uint64_t raw_ofs = 0;
+    for (ofs = 0; ofs < end; ofs += sizeof(hdr) + hdr.comp_len) {
+        memcpy(&hdr, &data[ofs], sizeof(hdr));
+        if (!AP_Logger_Compress::decode_block(hdr, &data[ofs+sizeof(hdr)], &buf[raw_ofs])) {
+            ::printf("Corrupt compressed block at offset %" PRIu64 "\n", ofs);
+            break;
+        }
+        raw_ofs += hdr.raw_len;
+    }
+    ::printf("Decompressed %" PRIu64 " bytes to %" PRIu64 "\n", len, raw_ofs);
+    mapped_log = buf;
+    mapped_log_on_heap = true;
+    file_size = raw_ofs;
+    return true;
 }
+#endif // AP_LOGGER_COMPRESSION_ENABLED
+#endif
 
 bool AP_LoggerFileReader::open_log(const char *logfile)
 {
+#if AP_LOGREADER_MMAP_ENABLED
+    if (map_log(logfile)) {
+        return true;
+    }
+#endif
     fd = AP::FS().open(logfile, O_RDONLY);
     if (fd == -1) {
         return false;
@@ -43,6 +155,29 @@ ssize_t AP_LoggerFileReader::read_input(void *buffer, const size_t count)
     return ret;
 }
 
+/*
+  return a pointer to the next count bytes of the log. When the log is
+  memory mapped this points into the mapping, otherwise the bytes are
+  read into buf. Returns nullptr at the end of the log
+ */
+uint8_t *AP_LoggerFileReader::next_bytes(uint8_t *buf, size_t count)
+{
+#if AP_LOGREADER_MMAP_ENABLED
+    if (mapped_log != nullptr) {
+        if (bytes_read + count > file_size) {
+            return nullptr;
+        }
+        uint8_t *ret = &mapped_log[bytes_read];
+        bytes_read += count;
+        return ret;
+    }
+#endif
+    if (read_input(buf, count) != (ssize_t)count) {
+        return nullptr;
+    }
+    return buf;
+}
+
 void AP_LoggerFileReader::format_type(uint16_t type, char dest[5])
 {
     const struct log_Format &f = formats[type];
@@ -59,8 +194,9 @@ void AP_LoggerFileReader::get_packet_counts(uint64_t dest[])
 
 bool AP_LoggerFileReader::update()
 {
-    uint8_t hdr[3];
-    if (read_input(hdr, 3) != 3) {
+    uint8_t hdr_buf[3];
+    const uint8_t *hdr = next_bytes(hdr_buf, 3);
+    if (hdr == nullptr) {
         return false;
     }
     if (hdr[0] != HEAD_BYTE1 || hdr[1] != HEAD_BYTE2) {
@@ -79,9 +215,13 @@ bool AP_LoggerFileReader::update()
     if (hdr[2] == LOG_FORMAT_MSG) {
         struct log_Format f;
         memcpy(&f, hdr, 3);
-        if (read_input(&f.type, sizeof(f)-3) != sizeof(f)-3) {
+        const uint8_t *body = next_bytes((uint8_t *)&f.type, sizeof(f)-3);
+        if (body == nullptr) {
             return false;
         }
+        if (body != (uint8_t *)&f.type) {
+            memcpy(&f.type, body, sizeof(f)-3);
+        }
         memcpy(&formats[f.type], &f, sizeof(formats[f.type]));
 
         message_count++;
@@ -96,12 +236,20 @@ bool AP_LoggerFileReader::update()
         exit(1);
     }
 
-    uint8_t msg[f.length];
+    uint8_t msg_buf[f.length];
 
-    memcpy(msg, hdr, 3);
-    if (read_input(&msg[3], f.length-3) != f.length-3) {
+    uint8_t *body = next_bytes(&msg_buf[3], f.length-3);
+    if (body == nullptr) {
         return false;
     }
+    uint8_t *msg;
+    if (body == &msg_buf[3]) {
+        memcpy(msg_buf, hdr, 3);
+        msg = msg_buf;
+    } else {
+        // mapped log, the header immediately precedes the body
+        msg = body - 3;
+    }
 
     message_count++;
     return handle_msg(f, msg);
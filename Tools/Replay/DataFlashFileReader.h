@@ -4,6 +4,10 @@
 
 #define LOGREADER_MAX_FORMATS 255 // must be >= highest MESSAGE
 
+#ifndef AP_LOGREADER_MMAP_ENABLED
+#define AP_LOGREADER_MMAP_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX)
+#endif
+
 class AP_LoggerFileReader
 {
 public:
@@ -28,6 +32,22 @@ protected:
 
 private:
     ssize_t read_input(void *buf, size_t count);
+    uint8_t *next_bytes(uint8_t *buf, size_t count);
+
+#if AP_LOGREADER_MMAP_ENABLED
+    bool map_log(const char *logfile);
+
+    // log mapped into memory, messages are handed out as pointers
+    // into this mapping rather than being copied
+    uint8_t *mapped_log = nullptr;
+
+#if AP_LOGGER_COMPRESSION_ENABLED
+    // compressed logs are decompressed into a heap buffer which then
+    // takes the place of the mapping
+    bool decompress_log(const uint8_t *data, uint64_t len);
+    bool mapped_log_on_heap = false;
+#endif
+#endif
 
     uint64_t bytes_read = 0;
     uint64_t file_size = 0; // Total size of the log file
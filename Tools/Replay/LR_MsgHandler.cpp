@@ -5,6 +5,9 @@
 #include <AP_DAL/AP_DAL.h>
 
 #include <cinttypes>
+#if CONFIG_HAL_BOARD != HAL_BOARD_CHIBIOS
+#include <time.h>
+#endif
 
 extern const AP_HAL::HAL& hal;
 
@@ -38,7 +41,48 @@ void LR_MsgHandler_RFRF::process_message(uint8_t *msgbytes)
         MAP_FLAG(AP_DAL::FrameType::LogWriteEKF2, AP_DAL::FrameType::LogWriteEKF3);
     }
 #undef MAP_FLAG
+    const uint8_t update_ekf3 = uint8_t(AP_DAL::FrameType::UpdateFilterEKF3);
+    if (!replay_ekf3_timing.enabled || !(msg.frame_types & update_ekf3)) {
+        AP::dal().handle_message(msg, ekf2, ekf3);
+        return;
+    }
+
+    /*
+      time the EKF3 update on its own. The frame is split so that
+      initialisation and the EKF2 update run before it and logging
+      runs after it, in the same order as AP_DAL::handle_message
+     */
+    const uint8_t frame_types = msg.frame_types;
+    const uint8_t log_write = uint8_t(AP_DAL::FrameType::LogWriteEKF2) | uint8_t(AP_DAL::FrameType::LogWriteEKF3);
+    msg.frame_types = frame_types & ~(update_ekf3 | log_write);
+    AP::dal().handle_message(msg, ekf2, ekf3);
+
+    // the first update may initialise the filter, which is not counted
+    const bool initialised = ekf3.activeCores() > 0;
+    msg.frame_types = update_ekf3;
+    const uint64_t start_ns = timing_ns();
     AP::dal().handle_message(msg, ekf2, ekf3);
+    const uint64_t dt_ns = timing_ns() - start_ns;
+    if (initialised) {
+        replay_ekf3_timing.update(dt_ns);
+    }
+
+    msg.frame_types = frame_types & log_write;
+    AP::dal().handle_message(msg, ekf2, ekf3);
+}
+
+/*
+  wall clock time in nanoseconds, independent of the time in the log
+ */
+uint64_t LR_MsgHandler_RFRF::timing_ns(void)
+{
+#if CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS
+    return AP_HAL::micros64() * 1000ULL;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec*1000000000ULL + ts.tv_nsec;
+#endif
 }
 
 void LR_MsgHandler_RFRN::process_message(uint8_t *msgbytes)
@@ -308,6 +352,7 @@ bool LR_MsgHandler_PARM::set_parameter(const char *name, const float value)
 {
     const char *ignore_parms[] = {
         "LOG_FILE_BUFSIZE",
+        "LOG_FILE_COMPRESS",
         "LOG_DISARMED"
     };
     for (uint8_t i=0; i < ARRAY_SIZE(ignore_parms); i++) {
@@ -43,6 +43,7 @@ class LR_MsgHandler_RFRF : public LR_MsgHandler_EKF
 {
     using LR_MsgHandler_EKF::LR_MsgHandler_EKF;
     void process_message(uint8_t *msg) override;
+    static uint64_t timing_ns(void);
 };
 
 class LR_MsgHandler_ROFH : public LR_MsgHandler_EKF
@@ -39,6 +39,7 @@ static ReplayVehicle replayvehicle;
 user_parameter *user_parameters;
 bool replay_force_ekf2;
 bool replay_force_ekf3;
+replay_ekf_timing replay_ekf3_timing;
 bool show_progress;
 
 const AP_Param::Info ReplayVehicle::var_info[] = {
@@ -126,11 +127,13 @@ void Replay::usage(void)
     ::printf("\t--force-ekf2 force enable EKF2\n");
     ::printf("\t--force-ekf3 force enable EKF3\n");
     ::printf("\t--progress  show a progress bar during replay\n");
+    ::printf("\t--ekf-timing  report the time taken by each EKF3 update\n");
 }
 
 enum param_key : uint8_t {
     FORCE_EKF2 = 1,
     FORCE_EKF3,
+    EKF_TIMING,
 };
 
 void Replay::_parse_command_line(uint8_t argc, char * const argv[])
@@ -143,6 +146,7 @@ void Replay::_parse_command_line(uint8_t argc, char * const argv[])
         {"force-ekf2",      false,  0, param_key::FORCE_EKF2},
         {"force-ekf3",      false,  0, param_key::FORCE_EKF3},
         {"progress",        false,  0, 'P'},
+        {"ekf-timing",      false,  0, param_key::EKF_TIMING},
         {"help",            false,  0, 'h'},
         {0, false, 0, 0}
     };
@@ -177,6 +181,10 @@ void Replay::_parse_command_line(uint8_t argc, char * const argv[])
         case param_key::FORCE_EKF3:
             replay_force_ekf3 = true;
             break;
+
+        case param_key::EKF_TIMING:
+            replay_ekf3_timing.enabled = true;
+            break;
             
         case 'P':
             show_progress = true;
@@ -297,6 +305,9 @@ void Replay::setup()
 void Replay::loop()
 {
     if (!reader.update()) {
+        if (replay_ekf3_timing.enabled) {
+            print_ekf_timing();
+        }
 #if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
     // If we don't tear down the threads then they continue to access
     // global state during object destruction.
@@ -335,6 +346,25 @@ void Replay::loop()
     }
 }
 
+/*
+  report the EKF3 update timing collected with --ekf-timing. Build
+  with --ekf-single and --ekf-double to compare the ftype variants
+ */
+void Replay::print_ekf_timing(void)
+{
+    const replay_ekf_timing &t = replay_ekf3_timing;
+    ::printf("EKF3 UpdateFilter timing (ftype=%s, %u cores): %u calls",
+             sizeof(ftype) == sizeof(double) ? "double" : "float",
+             unsigned(_vehicle.ekf3.activeCores()),
+             unsigned(t.count));
+    if (t.count > 0) {
+        ::printf(", mean %llu ns/call, max %llu ns",
+                 (unsigned long long)(t.total_ns / t.count),
+                 (unsigned long long)t.max_ns);
+    }
+    ::printf("\n");
+}
+
 /*
   setup user -p parameters
  */
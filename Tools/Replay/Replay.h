@@ -31,6 +31,21 @@ extern user_parameter *user_parameters;
 extern bool replay_force_ekf2;
 extern bool replay_force_ekf3;
 
+// wall clock timing of EKF3 UpdateFilter calls, enabled with --ekf-timing
+struct replay_ekf_timing {
+    bool enabled;
+    uint32_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+
+    void update(uint64_t dt_ns) {
+        count++;
+        total_ns += dt_ns;
+        max_ns = MAX(max_ns, dt_ns);
+    }
+};
+extern replay_ekf_timing replay_ekf3_timing;
+
 class ReplayVehicle : public AP_Vehicle {
 public:
     friend class Replay;
@@ -112,4 +127,5 @@ private:
 
     void Write_Format(const struct LogStructure &s);
     void write_EKF_formats(void);
+    void print_ekf_timing(void);
 };
@@ -0,0 +1,235 @@
+#!/usr/bin/env python3
+
+# flake8: noqa
+
+'''
+Run Replay over many logs in parallel, one Replay process per log.
+
+Logs can be given as files, directories (searched recursively for
+.BIN files) or manifest files (one log path per line, '#' comments
+allowed, given with --manifest). Each log is replayed in its own
+scratch directory so the Replay output logs never collide, then the
+output is checked with check_replay.py and summarised.
+
+A JSON summary is written with one entry per log containing the
+replay time, the check_replay result, the peak EKF innovations and
+a divergence flag. A core is flagged as diverged when one of its XKF4
+innovation test ratios stays above the limit, or its fault status
+stays non-zero, for a run of consecutive samples. Single samples are
+expected as measurements are occasionally rejected.
+'''
+
+import glob
+import hashlib
+import json
+import multiprocessing
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+import check_replay
+
+# innovation fields of XKF3 summarised per log
+INNOVATION_FIELDS = ['IVN', 'IVE', 'IVD', 'IPN', 'IPE', 'IPD', 'IMX', 'IMY', 'IMZ', 'IYAW']
+
+# XKF4 test ratio fields, a value above 1 means the measurement was rejected
+TEST_RATIO_FIELDS = ['SV', 'SP', 'SH', 'SM', 'SVT']
+
+
+def find_logs(paths, manifests):
+    '''expand the list of files, directories and manifests into a sorted list of logs'''
+    logs = set()
+    for manifest in manifests:
+        with open(manifest) as f:
+            for line in f:
+                line = line.strip()
+                if not line or line.startswith('#'):
+                    continue
+                paths.append(os.path.join(os.path.dirname(manifest), line))
+    for path in paths:
+        if os.path.isdir(path):
+            for ext in ['*.BIN', '*.bin']:
+                logs.update(glob.glob(os.path.join(path, '**', ext), recursive=True))
+        else:
+            logs.add(path)
+    return sorted([os.path.abspath(x) for x in logs])
+
+
+def summarise_output(logfile, max_test_ratio, diverge_samples):
+    '''gather peak innovations and divergence flags for the replayed cores'''
+    from pymavlink import mavutil
+
+    innovations = {}
+    # total samples above the limit, and the longest run of them, per field
+    test_ratio_exceeded = {}
+    test_ratio_run_max = {}
+    fault_samples = 0
+    fault_run_max = 0
+    # current runs, keyed by core
+    test_ratio_run = {}
+    fault_run = {}
+    mlog = mavutil.mavlink_connection(logfile)
+    while True:
+        m = mlog.recv_match(type=['XKF3', 'XKF4'])
+        if m is None:
+            break
+        # replayed cores are logged with core numbers offset by 100
+        if m.C < 100:
+            continue
+        if m.get_type() == 'XKF3':
+            for f in INNOVATION_FIELDS:
+                v = abs(getattr(m, f))
+                if v > innovations.get(f, 0):
+                    innovations[f] = v
+        else:
+            runs = test_ratio_run.setdefault(m.C, {})
+            for f in TEST_RATIO_FIELDS:
+                if getattr(m, f) > max_test_ratio:
+                    test_ratio_exceeded[f] = test_ratio_exceeded.get(f, 0) + 1
+                    runs[f] = runs.get(f, 0) + 1
+                    test_ratio_run_max[f] = max(test_ratio_run_max.get(f, 0), runs[f])
+                else:
+                    runs[f] = 0
+            if m.FS != 0:
+                fault_samples += 1
+                fault_run[m.C] = fault_run.get(m.C, 0) + 1
+                fault_run_max = max(fault_run_max, fault_run[m.C])
+            else:
+                fault_run[m.C] = 0
+    diverged_fields = sorted([f for f in test_ratio_run_max if test_ratio_run_max[f] >= diverge_samples])
+    return {
+        'innovations_max': innovations,
+        'test_ratio_exceeded': test_ratio_exceeded,
+        'test_ratio_run_max': test_ratio_run_max,
+        'fault_samples': fault_samples,
+        'fault_run_max': fault_run_max,
+        'diverged_fields': diverged_fields,
+        'diverged': len(diverged_fields) > 0 or fault_run_max >= diverge_samples,
+    }
+
+
+def replay_one(job):
+    '''replay a single log in a scratch directory, returning a summary dict'''
+    (logfile, replay, replay_args, keep_dir, args) = job
+    result = {
+        'log': logfile,
+        'ok': False,
+    }
+    workdir = tempfile.mkdtemp(prefix='replay-')
+    messages = []
+    try:
+        cmd = [replay] + replay_args + [logfile]
+        t0 = time.time()
+        p = subprocess.run(cmd, cwd=workdir, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, timeout=args.timeout)
+        result['replay_time_s'] = round(time.time() - t0, 3)
+        result['returncode'] = p.returncode
+        if p.returncode != 0:
+            result['error'] = p.stdout.decode('utf-8', errors='replace')[-2000:]
+            return result
+
+        outputs = sorted(glob.glob(os.path.join(workdir, 'logs', '*.BIN')))
+        if len(outputs) != 1:
+            result['error'] = "Expected a single output log, found %u" % len(outputs)
+            return result
+        output = outputs[0]
+        if keep_dir is not None:
+            # logs from different directories often share a name, so
+            # include a hash of the full input path
+            (base, ext) = os.path.splitext(os.path.basename(logfile))
+            path_hash = hashlib.sha1(logfile.encode('utf-8')).hexdigest()[:10]
+            dest = os.path.join(keep_dir, "%s-%s%s" % (base, path_hash, ext))
+            shutil.copy(output, dest)
+            result['output'] = dest
+
+        result['check_ok'] = check_replay.check_log(output,
+                                                    progress=messages.append,
+                                                    ekf2_only=args.ekf2_only,
+                                                    ekf3_only=args.ekf3_only,
+                                                    accuracy=args.accuracy)
+        result['check_messages'] = messages[-20:]
+        result.update(summarise_output(output, args.max_test_ratio, args.diverge_samples))
+        result['ok'] = result['check_ok'] and not result['diverged']
+    except subprocess.TimeoutExpired:
+        result['error'] = "Timeout after %u seconds" % args.timeout
+    except Exception as ex:
+        result['error'] = str(ex)
+    finally:
+        shutil.rmtree(workdir, ignore_errors=True)
+    return result
+
+
+if __name__ == '__main__':
+    from argparse import ArgumentParser
+    parser = ArgumentParser(description=__doc__)
+    parser.add_argument("--replay", default="build/sitl/tool/Replay", help="path to Replay binary")
+    parser.add_argument("-j", "--jobs", type=int, default=multiprocessing.cpu_count(), help="number of parallel Replay processes")
+    parser.add_argument("--manifest", action='append', default=[], help="file containing a list of logs to replay")
+    parser.add_argument("--parm", action='append', default=[], help="NAME=VALUE parameter passed to Replay")
+    parser.add_argument("--param-file", default=None, help="parameter file passed to Replay")
+    parser.add_argument("--force-ekf2", action='store_true', help="force enable EKF2")
+    parser.add_argument("--force-ekf3", action='store_true', help="force enable EKF3")
+    parser.add_argument("--ekf2-only", action='store_true', help="only check EKF2")
+    parser.add_argument("--ekf3-only", action='store_true', help="only check EKF3")
+    parser.add_argument("--accuracy", type=float, default=0.0, help="accuracy percentage for match")
+    parser.add_argument("--max-test-ratio", type=float, default=1.0, help="XKF4 test ratio above which a sample counts towards divergence")
+    parser.add_argument("--diverge-samples", type=int, default=50, help="consecutive XKF4 samples over the test ratio, or with a fault, to flag a core as diverged")
+    parser.add_argument("--timeout", type=int, default=3600, help="timeout in seconds for each Replay run")
+    parser.add_argument("--keep-output", default=None, help="directory to copy Replay output logs into")
+    parser.add_argument("--summary", default="replay_summary.json", help="JSON summary output file")
+    parser.add_argument("logs", metavar="LOG", nargs="*", help="log files or directories")
+
+    args = parser.parse_args()
+
+    replay = os.path.abspath(args.replay)
+    if not os.path.exists(replay):
+        print("Replay binary %s not found, build it with ./waf replay" % replay)
+        sys.exit(1)
+
+    replay_args = []
+    for p in args.parm:
+        replay_args.extend(["--parm", p])
+    if args.param_file is not None:
+        replay_args.extend(["--param-file", os.path.abspath(args.param_file)])
+    if args.force_ekf2:
+        replay_args.append("--force-ekf2")
+    if args.force_ekf3:
+        replay_args.append("--force-ekf3")
+
+    keep_dir = None
+    if args.keep_output is not None:
+        keep_dir = os.path.abspath(args.keep_output)
+        os.makedirs(keep_dir, exist_ok=True)
+
+    logs = find_logs(args.logs, args.manifest)
+    if len(logs) == 0:
+        print("No logs found")
+        sys.exit(1)
+
+    print("Replaying %u logs with %u jobs" % (len(logs), args.jobs))
+    jobs = [(log, replay, replay_args, keep_dir, args) for log in logs]
+    results = []
+    t0 = time.time()
+    with multiprocessing.Pool(args.jobs) as pool:
+        for r in pool.imap_unordered(replay_one, jobs):
+            results.append(r)
+            print("[%u/%u] %s %s" % (len(results), len(logs), "OK" if r['ok'] else "FAILED", r['log']))
+
+    results.sort(key=lambda r: r['log'])
+    failed = [r for r in results if not r['ok']]
+    with open(args.summary, 'w') as f:
+        json.dump({
+            'total_time_s': round(time.time() - t0, 3),
+            'num_logs': len(results),
+            'num_failed': len(failed),
+            'logs': results,
+        }, f, indent=2)
+    print("Summary written to %s" % args.summary)
+
+    if len(failed) > 0:
+        print("FAILED %u/%u logs" % (len(failed), len(results)))
+        sys.exit(1)
+    print("Passed")
+    sys.exit(0)
@@ -551,6 +551,12 @@ for t in $CI_BUILD_TARGET; do
              --extra-hwdef=/tmp/extra.hwdef
         time ./waf plane
         time ./waf copter
+        echo "Checking building with a high resolution proximity boundary works"
+        printf "define PROXIMITY_NUM_SECTORS 72\ndefine PROXIMITY_NUM_LAYERS 9\n" >/tmp/extra.hwdef
+        time ./waf configure \
+             --board=CubeOrange \
+             --extra-hwdef=/tmp/extra.hwdef
+        time ./waf copter
         continue
     fi
 
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+
+'''
+decompress a log written with LOG_FILE_COMPRESS enabled
+
+Compressed logs are a sequence of frames, each an 8 byte header
+(magic "LZ4B", uncompressed length, payload length) followed by a LZ4
+block, or the raw bytes if the payload length equals the uncompressed
+length. A log closed cleanly ends with a 12 byte trailer (magic "LZ4E",
+uncompressed size, offset where the frames end). Logs downloaded over MAVLink are
+already decompressed.
+
+./Tools/scripts/decompress_log.py 00000042.BIN 00000042-raw.BIN
+
+AP_FLAKE8_CLEAN
+'''
+
+import struct
+import sys
+from argparse import ArgumentParser
+
+MAGIC = b'LZ4B'
+HEADER = struct.Struct('<4sHH')
+TRAILER_MAGIC = b'LZ4E'
+TRAILER = struct.Struct('<4sII')
+
+
+def decompress_block(src, raw_len):
+    '''decompress one LZ4 block'''
+    dst = bytearray()
+    ip = 0
+    while ip < len(src):
+        token = src[ip]
+        ip += 1
+        lit_len = token >> 4
+        if lit_len == 15:
+            while True:
+                b = src[ip]
+                ip += 1
+                lit_len += b
+                if b != 255:
+                    break
+        dst += src[ip:ip+lit_len]
+        ip += lit_len
+        if ip >= len(src):
+            break
+        offset = src[ip] | (src[ip+1] << 8)
+        ip += 2
+        match_len = token & 0x0F
+        if match_len == 15:
+            while True:
+                b = src[ip]
+                ip += 1
+                match_len += b
+                if b != 255:
+                    break
+        match_len += 4
+        if offset == 0 or offset > len(dst):
+            raise ValueError("bad match offset")
+        start = len(dst) - offset
+        for i in range(match_len):
+            dst.append(dst[start+i])
+    if len(dst) != raw_len:
+        raise ValueError("bad block length")
+    return dst
+
+
+def decompress(data):
+    '''decompress a whole log, stopping at the trailer or a truncated final frame'''
+    out = bytearray()
+    ofs = 0
+    end = len(data)
+    if len(data) >= TRAILER.size:
+        (magic, raw_size, comp_size) = TRAILER.unpack_from(data, len(data) - TRAILER.size)
+        if magic == TRAILER_MAGIC and HEADER.size <= comp_size <= len(data) - TRAILER.size:
+            end = comp_size
+    while ofs + HEADER.size <= end:
+        (magic, raw_len, comp_len) = HEADER.unpack_from(data, ofs)
+        if magic != MAGIC or ofs + HEADER.size + comp_len > end:
+            break
+        payload = data[ofs+HEADER.size:ofs+HEADER.size+comp_len]
+        if comp_len == raw_len:
+            out += payload
+        else:
+            out += decompress_block(payload, raw_len)
+        ofs += HEADER.size + comp_len
+    if ofs == end and end != len(data):
+        ofs = len(data)
+    return (out, ofs)
+
+
+if __name__ == '__main__':
+    parser = ArgumentParser(description=__doc__)
+    parser.add_argument("input", help="compressed log")
+    parser.add_argument("output", help="decompressed log")
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        data = f.read()
+    if data[:4] != MAGIC:
+        print("%s is not a compressed log" % args.input)
+        sys.exit(1)
+    (out, used) = decompress(data)
+    if used != len(data):
+        print("Ignoring %u bytes of truncated data at end of log" % (len(data) - used))
+    with open(args.output, 'wb') as f:
+        f.write(out)
+    print("Decompressed %u bytes to %u bytes" % (len(data), len(out)))
@@ -1205,7 +1205,7 @@ void AC_Avoid::adjust_velocity_proximity(float kP, float accel_cmss, Vector3f &d
 
     AP_Proximity &_proximity = *proximity;
     // get total number of obstacles
-    const uint8_t obstacle_num = _proximity.get_obstacle_count();
+    const uint16_t obstacle_num = _proximity.get_obstacle_count();
     if (obstacle_num == 0) {
         // no obstacles
         return;
@@ -1234,7 +1234,8 @@ void AC_Avoid::adjust_velocity_proximity(float kP, float accel_cmss, Vector3f &d
         stopping_point_plus_margin = safe_vel * ((2.0f + margin_cm + get_stopping_distance(kP, accel_cmss, speed))/speed);
     }
 
-    for (uint8_t i = 0; i<obstacle_num; i++) {
+    // only visit the faces with a valid distance, most are empty
+    for (uint16_t i = _proximity.get_next_obstacle(0); i<obstacle_num; i = _proximity.get_next_obstacle(i+1)) {
         // get obstacle from proximity library
         Vector3f vector_to_obstacle;
         if (!_proximity.get_obstacle(i, vector_to_obstacle)) {
@@ -560,9 +560,11 @@ bool AP_OABendyRuler::calc_margin_from_inclusion_and_exclusion_polygons(const Lo
     for (uint8_t i = 0; i < num_inclusion_polygons; i++) {
         uint16_t num_points;
         const Vector2f* boundary = fence->polyfence().get_inclusion_polygon(i, num_points);
+        const auto *bounds = fence->polyfence().get_inclusion_polygon_bounds(i);
      
         // if outside the fence margin is the closest distance but with negative sign
-        const float sign = Polygon_outside(start_NE, boundary, num_points) ? -1.0f : 1.0f;
+        const bool outside = bounds->outside(start_NE) || Polygon_outside(start_NE, boundary, num_points);
+        const float sign = outside ? -1.0f : 1.0f;
 
         // calculate min distance (in meters) from line to polygon
         float margin_new = (sign * Polygon_closest_distance_line(boundary, num_points, start_NE, end_NE) * 0.01f) - fence_margin;
@@ -576,9 +578,19 @@ bool AP_OABendyRuler::calc_margin_from_inclusion_and_exclusion_polygons(const Lo
     for (uint8_t i = 0; i < num_exclusion_polygons; i++) {
         uint16_t num_points;
         const Vector2f* boundary = fence->polyfence().get_exclusion_polygon(i, num_points);
+        const auto *bounds = fence->polyfence().get_exclusion_polygon_bounds(i);
+
+        // skip polygons which are further from the path than the
+        // current margin, their margin can only be larger
+        const bool start_outside_bounds = bounds->outside(start_NE);
+        if (margin_updated && start_outside_bounds &&
+            bounds->distance_lower_bound_cm(start_NE, end_NE) * 0.01f - fence_margin >= margin) {
+            continue;
+        }
    
         // if start is inside the polygon the margin's sign is reversed
-        const float sign = Polygon_outside(start_NE, boundary, num_points) ? 1.0f : -1.0f;
+        const bool outside = start_outside_bounds || Polygon_outside(start_NE, boundary, num_points);
+        const float sign = outside ? 1.0f : -1.0f;
 
         // calculate min distance (in meters) from line to polygon
         float margin_new = (sign * Polygon_closest_distance_line(boundary, num_points, start_NE, end_NE) * 0.01f) - fence_margin;
@@ -695,25 +707,8 @@ bool AP_OABendyRuler::calc_margin_from_object_database(const Location &start, co
         return false;
     }
 
-    // check each obstacle's distance from segment
-    float smallest_margin = FLT_MAX;
-    for (uint16_t i=0; i<oaDb->database_count(); i++) {
-        const AP_OADatabase::OA_DbItem& item = oaDb->get_item(i);
-        const Vector3f point_cm = item.pos * 100.0f;
-        // margin is distance between line segment and obstacle minus obstacle's radius
-        const float m = Vector3f::closest_distance_between_line_and_point(start_NEU, end_NEU, point_cm) * 0.01f - item.radius;
-        if (m < smallest_margin) {
-            smallest_margin = m;
-        }
-    }
-
-    // return smallest margin
-    if (smallest_margin < FLT_MAX) {
-        margin = smallest_margin;
-        return true;
-    }
-
-    return false;
+    // margin is distance between line segment and closest obstacle minus obstacle's radius
+    return oaDb->get_closest_margin_to_segment(start_NEU * 0.01f, end_NEU * 0.01f, margin);
 }
 
 #endif  // AP_OAPATHPLANNER_BENDYRULER_ENABLED
@@ -40,6 +40,14 @@ extern const AP_HAL::HAL& hal;
     #define AP_OADATABASE_DISTANCE_FROM_HOME 3
 #endif
 
+#ifndef AP_OADATABASE_GRID_CELL_SIZE
+    #define AP_OADATABASE_GRID_CELL_SIZE 5.0f       // width (in meters) of the spatial hash grid cells
+#endif
+
+#ifndef AP_OADATABASE_GRID_BUCKETS_MAX
+    #define AP_OADATABASE_GRID_BUCKETS_MAX 4096
+#endif
+
 const AP_Param::GroupInfo AP_OADatabase::var_info[] = {
 
     // @Param: SIZE
@@ -135,6 +143,10 @@ void AP_OADatabase::init()
         GCS_SEND_TEXT(MAV_SEVERITY_INFO, "DB init failed . Sizes queue:%u, db:%u", (unsigned int)_queue.size, (unsigned int)_database.size);
         delete _queue.items;
         delete[] _database.items;
+        delete[] _grid.heads;
+        delete[] _grid.next;
+        _grid.heads = nullptr;
+        _grid.next = nullptr;
         return;
     }
 }
@@ -222,6 +234,68 @@ void AP_OADatabase::init_database()
     }
 
     _database.items = NEW_NOTHROW OA_DbItem[_database.size];
+
+    // allocate the spatial hash with roughly one bucket per item.  On failure the
+    // database still works but matching and queries fall back to scanning every item
+    _grid.num_buckets = 16;
+    while ((_grid.num_buckets < _database.size) && (_grid.num_buckets < AP_OADATABASE_GRID_BUCKETS_MAX)) {
+        _grid.num_buckets <<= 1;
+    }
+    _grid.heads = NEW_NOTHROW uint16_t[_grid.num_buckets];
+    _grid.next = NEW_NOTHROW uint16_t[_database.size];
+    if ((_grid.heads == nullptr) || (_grid.next == nullptr)) {
+        delete[] _grid.heads;
+        delete[] _grid.next;
+        _grid.heads = nullptr;
+        _grid.next = nullptr;
+        return;
+    }
+    for (uint16_t i=0; i<_grid.num_buckets; i++) {
+        _grid.heads[i] = GRID_NONE;
+    }
+}
+
+// return grid cell number holding a position (in meters) along one axis
+int32_t AP_OADatabase::grid_cell(float pos_m)
+{
+    return (int32_t)floorf(pos_m * (1.0f / AP_OADATABASE_GRID_CELL_SIZE));
+}
+
+// return hash bucket for a grid cell
+uint16_t AP_OADatabase::grid_bucket(int32_t cell_x, int32_t cell_y) const
+{
+    const uint32_t hash = ((uint32_t)cell_x * 73856093U) ^ ((uint32_t)cell_y * 19349663U);
+    return hash & (_grid.num_buckets - 1);
+}
+
+// add database item to the grid
+void AP_OADatabase::grid_insert(const uint16_t index)
+{
+    if (_grid.heads == nullptr) {
+        return;
+    }
+    const OA_DbItem &item = _database.items[index];
+    const uint16_t bucket = grid_bucket(grid_cell(item.pos.x), grid_cell(item.pos.y));
+    _grid.next[index] = _grid.heads[bucket];
+    _grid.heads[bucket] = index;
+    _grid.max_radius = MAX(_grid.max_radius, item.radius);
+}
+
+// remove database item from the grid.  Must be called before the item's position is changed
+void AP_OADatabase::grid_remove(const uint16_t index)
+{
+    if (_grid.heads == nullptr) {
+        return;
+    }
+    const OA_DbItem &item = _database.items[index];
+    uint16_t *link = &_grid.heads[grid_bucket(grid_cell(item.pos.x), grid_cell(item.pos.y))];
+    for (uint16_t steps=0; (*link != GRID_NONE) && (steps < _database.size); steps++) {
+        if (*link == index) {
+            *link = _grid.next[index];
+            return;
+        }
+        link = &_grid.next[*link];
+    }
 }
 
 // get bitmask of gcs channels item should be sent to based on its importance
@@ -303,21 +377,126 @@ bool AP_OADatabase::process_queue()
 
         item.send_to_gcs = get_send_to_gcs_flags(item.importance);
 
-        // compare item to all items in database. If found a similar item, update the existing, else add it as a new one
-        bool found = false;
-        for (uint16_t i=0; i<_database.count; i++) {
-            if (item_match(_database.items[i], item)) {
-                database_item_refresh(_database.items[i], item);
-                found = true;
+        // compare item to items in database. If found a similar item, update the existing, else add it as a new one
+        const uint16_t match_idx = database_find_match(item);
+        if (match_idx != GRID_NONE) {
+            database_item_refresh(match_idx, item);
+        } else {
+            database_item_add(item);
+        }
+    }
+    return (_queue.items->available() > 0);
+}
+
+// return index of the lowest numbered database item matching item, or GRID_NONE if none match
+uint16_t AP_OADatabase::database_find_match(const OA_DbItem &item) const
+{
+    uint16_t match_idx = GRID_NONE;
+
+    // proximity items can only match items closer than the larger of the two radii so only the grid cells
+    // within that distance are searched, unless there are more cells than items
+    if ((item.source == OA_DbItem::Source::proximity) && (_grid.heads != nullptr)) {
+        const float search_radius = MAX(item.radius, _grid.max_radius);
+        const int32_t x_min = grid_cell(item.pos.x - search_radius);
+        const int32_t x_max = grid_cell(item.pos.x + search_radius);
+        const int32_t y_min = grid_cell(item.pos.y - search_radius);
+        const int32_t y_max = grid_cell(item.pos.y + search_radius);
+        if ((uint32_t)(x_max - x_min + 1) * (uint32_t)(y_max - y_min + 1) <= _database.count) {
+            for (int32_t cx = x_min; cx <= x_max; cx++) {
+                for (int32_t cy = y_min; cy <= y_max; cy++) {
+                    uint16_t idx = _grid.heads[grid_bucket(cx, cy)];
+                    for (uint16_t steps=0; (idx < _database.count) && (steps < _database.count); steps++) {
+                        if ((idx < match_idx) && item_match(_database.items[idx], item)) {
+                            match_idx = idx;
+                        }
+                        idx = _grid.next[idx];
+                    }
+                }
+            }
+            return match_idx;
+        }
+    }
+
+    for (uint16_t i=0; i<_database.count; i++) {
+        if (item_match(_database.items[i], item)) {
+            match_idx = i;
+            break;
+        }
+    }
+    return match_idx;
+}
+
+// get the smallest distance (in meters) between a line segment and the edge of any object in the database
+// start and end are offsets in meters from the EKF origin
+// returns true on success and updates margin, false if the database is empty
+bool AP_OADatabase::get_closest_margin_to_segment(const Vector3f &start, const Vector3f &end, float &margin) const
+{
+    if (!healthy() || (_database.count == 0)) {
+        return false;
+    }
+
+    float smallest_margin = FLT_MAX;
+
+    // search outwards from the grid cells covering the segment one ring of cells at a time.  Items
+    // beyond ring r are at least r-1 cells from the segment so the search stops once that distance
+    // less the largest radius can not beat the smallest margin found so far
+    bool search_complete = false;
+    if (_grid.heads != nullptr) {
+        const int32_t x_min = grid_cell(MIN(start.x, end.x));
+        const int32_t x_max = grid_cell(MAX(start.x, end.x));
+        const int32_t y_min = grid_cell(MIN(start.y, end.y));
+        const int32_t y_max = grid_cell(MAX(start.y, end.y));
+        uint16_t num_visited = 0;
+        for (int32_t ring = 0; ; ring++) {
+            if (num_visited >= _database.count) {
+                search_complete = true;
+                break;
+            }
+            if ((ring > 0) && ((ring - 1) * AP_OADATABASE_GRID_CELL_SIZE - _grid.max_radius >= smallest_margin)) {
+                search_complete = true;
+                break;
+            }
+            const uint32_t width = x_max - x_min + 1 + 2 * ring;
+            const uint32_t height = y_max - y_min + 1 + 2 * ring;
+            const uint32_t ring_cells = (ring == 0) ? width * height : 2 * (width + height) - 4;
+            if (ring_cells > (uint32_t)(_database.count - num_visited)) {
+                // cheaper to check every item
                 break;
             }
+            for (int32_t cx = x_min - ring; cx <= x_max + ring; cx++) {
+                // interior columns of a ring only hold the top and bottom cells
+                const bool edge_column = (ring == 0) || (cx == x_min - ring) || (cx == x_max + ring);
+                const int32_t cy_step = edge_column ? 1 : (y_max - y_min + 2 * ring);
+                for (int32_t cy = y_min - ring; cy <= y_max + ring; cy += MAX(cy_step, 1)) {
+                    uint16_t idx = _grid.heads[grid_bucket(cx, cy)];
+                    for (uint16_t steps=0; (idx < _database.count) && (steps < _database.count); steps++) {
+                        const OA_DbItem &item = _database.items[idx];
+                        // skip items from other cells sharing this bucket
+                        if ((grid_cell(item.pos.x) == cx) && (grid_cell(item.pos.y) == cy)) {
+                            num_visited++;
+                            const float m = Vector3f::closest_distance_between_line_and_point(start, end, item.pos) - item.radius;
+                            smallest_margin = MIN(smallest_margin, m);
+                        }
+                        idx = _grid.next[idx];
+                    }
+                }
+            }
         }
+    }
 
-        if (!found) {
-            database_item_add(item);
+    if (!search_complete) {
+        for (uint16_t i=0; i<_database.count; i++) {
+            const OA_DbItem &item = _database.items[i];
+            const float m = Vector3f::closest_distance_between_line_and_point(start, end, item.pos) - item.radius;
+            smallest_margin = MIN(smallest_margin, m);
         }
     }
-    return (_queue.items->available() > 0);
+
+    if (smallest_margin < FLT_MAX) {
+        margin = smallest_margin;
+        return true;
+    }
+    return false;
 }
 
 void AP_OADatabase::database_item_add(const OA_DbItem &item)
@@ -327,6 +506,7 @@ void AP_OADatabase::database_item_add(const OA_DbItem &item)
     }
     _database.items[_database.count] = item;
     _database.items[_database.count].send_to_gcs = get_send_to_gcs_flags(_database.items[_database.count].importance);
+    grid_insert(_database.count);
     _database.count++;
 }
 
@@ -337,24 +517,31 @@ void AP_OADatabase::database_item_remove(const uint16_t index)
         return;
     }
 
+    grid_remove(index);
+
     // radius of 0 tells the GCS we don't care about it any more (aka it expired)
     _database.items[index].radius = 0;
     _database.items[index].send_to_gcs = get_send_to_gcs_flags(_database.items[index].importance);
 
     _database.count--;
     if (_database.count == 0) {
+        // nothing left so the largest radius can be forgotten
+        _grid.max_radius = 0;
         return;
     }
 
     if (index != _database.count) {
         // copy last object in array over expired object
+        grid_remove(_database.count);
         _database.items[index] = _database.items[_database.count];
         _database.items[index].send_to_gcs = get_send_to_gcs_flags(_database.items[index].importance);
+        grid_insert(index);
     }
 }
 
-void AP_OADatabase::database_item_refresh(OA_DbItem &current_item, const OA_DbItem &new_item) const
+void AP_OADatabase::database_item_refresh(const uint16_t index, const OA_DbItem &new_item)
 {
+    OA_DbItem &current_item = _database.items[index];
     const bool is_different =
             (!is_equal(current_item.radius, new_item.radius)) ||
             (new_item.timestamp_ms - current_item.timestamp_ms >= 500);
@@ -362,6 +549,9 @@ void AP_OADatabase::database_item_refresh(OA_DbItem &current_item, const OA_DbIt
     if (is_different) {
         // update timestamp and radius on close object so it stays around longer
         // and trigger resending to GCS
+        // item is moved to the grid cell for its new position
+        grid_remove(index);
+
         current_item.timestamp_ms = new_item.timestamp_ms;
         current_item.radius = new_item.radius;
         current_item.send_to_gcs = get_send_to_gcs_flags(current_item.importance);
@@ -370,6 +560,8 @@ void AP_OADatabase::database_item_refresh(OA_DbItem &current_item, const OA_DbIt
             // Update position for AIS items, these tend to be large and update slowly
             current_item.pos = new_item.pos;
         }
+
+        grid_insert(index);
     }
 }
 
@@ -61,6 +61,11 @@ public:
     // get number of items in the database
     uint16_t database_count() const { return _database.count; }
 
+    // get the smallest distance (in meters) between a line segment and the edge of any object in the database
+    // start and end are offsets in meters from the EKF origin
+    // returns true on success and updates margin, false if the database is empty
+    bool get_closest_margin_to_segment(const Vector3f &start, const Vector3f &end, float &margin) const;
+
     // empty queue and try and put into database. Return true if there's more work to do
     bool process_queue();
 
@@ -77,10 +82,19 @@ private:
 
     // database item management
     void database_item_add(const OA_DbItem &item);
-    void database_item_refresh(OA_DbItem &current_item, const OA_DbItem &new_item) const;
+    void database_item_refresh(const uint16_t index, const OA_DbItem &new_item);
     void database_item_remove(const uint16_t index);
     void database_items_remove_all_expired();
 
+    // return index of the lowest numbered database item matching item, or GRID_NONE if none match
+    uint16_t database_find_match(const OA_DbItem &item) const;
+
+    // spatial hash grid management
+    static int32_t grid_cell(float pos_m);
+    uint16_t grid_bucket(int32_t cell_x, int32_t cell_y) const;
+    void grid_insert(const uint16_t index);
+    void grid_remove(const uint16_t index);
+
     // get bitmask of gcs channels item should be sent to based on its importance
     // returns 0xFF (send to all channels) if should be sent or 0 if it should not be sent
     uint8_t get_send_to_gcs_flags(const OA_DbItemImportance importance) const;
@@ -119,6 +133,16 @@ private:
         uint16_t        size;                               // cached value of _database_size_param that sticks after initialized
     } _database;
 
+    // spatial hash of database items by horizontal position.  Items in the same grid cell
+    // share a bucket, and items in a bucket are chained through the next array
+    static const uint16_t GRID_NONE = UINT16_MAX;
+    struct {
+        uint16_t        *heads;                             // index of first item in each bucket or GRID_NONE (nullptr if allocation failed)
+        uint16_t        *next;                              // index of next item in the same bucket or GRID_NONE, one per database item
+        uint16_t        num_buckets;                        // number of buckets, always a power of two
+        float           max_radius;                         // largest item radius seen since the database was last empty
+    } _grid;
+
     uint16_t _next_index_to_send[MAVLINK_COMM_NUM_BUFFERS]; // index of next object in _database to send to GCS
     uint16_t _highest_index_sent[MAVLINK_COMM_NUM_BUFFERS]; // highest index in _database sent to GCS
     uint32_t _last_send_to_gcs_ms[MAVLINK_COMM_NUM_BUFFERS];// system time that send_adsb_vehicle was last called
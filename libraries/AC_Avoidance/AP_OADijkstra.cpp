@@ -31,6 +31,7 @@
 #define OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK  32      // expanding arrays for fence points and paths to destination will grow in increments of 20 elements
 #define OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX        255     // index use to indicate we do not have a tentative short path for a node
 #define OA_DIJKSTRA_ERROR_REPORTING_INTERVAL_MS         5000    // failure messages sent to GCS every 5 seconds
+#define OA_DIJKSTRA_SEARCH_NODES_PER_UPDATE             16      // maximum nodes visited by the shortest path search per call to update
 
 /// Constructor
 AP_OADijkstra::AP_OADijkstra(AP_Int16 &options) :
@@ -76,21 +77,21 @@ AP_OADijkstra::AP_OADijkstra_State AP_OADijkstra::update(const Location &current
     if (check_inclusion_polygon_updated()) {
         _inclusion_polygon_with_margin_ok = false;
         _polyfence_visgraph_ok = false;
-        _shortest_path_ok = false;
+        abort_shortest_path();
     }
 
     // check for exclusion polygon updates
     if (check_exclusion_polygon_updated()) {
         _exclusion_polygon_with_margin_ok = false;
         _polyfence_visgraph_ok = false;
-        _shortest_path_ok = false;
+        abort_shortest_path();
     }
 
     // check for exclusion circle updates
     if (check_exclusion_circle_updated()) {
         _exclusion_circle_with_margin_ok = false;
         _polyfence_visgraph_ok = false;
-        _shortest_path_ok = false;
+        abort_shortest_path();
     }
 
     // create inner polygon fence
@@ -130,7 +131,7 @@ AP_OADijkstra::AP_OADijkstra_State AP_OADijkstra::update(const Location &current
     if (!_polyfence_visgraph_ok) {
         _polyfence_visgraph_ok = create_fence_visgraph(_error_id);
         if (!_polyfence_visgraph_ok) {
-            _shortest_path_ok = false;
+            abort_shortest_path();
             dest_to_next_dest_clear = _dest_to_next_dest_clear = false;
             report_error(_error_id);
             Write_OADijkstra(DIJKSTRA_STATE_ERROR, (uint8_t)_error_id, 0, 0, destination, destination);
@@ -155,18 +156,40 @@ AP_OADijkstra::AP_OADijkstra_State AP_OADijkstra::update(const Location &current
     if (!destination.same_latlon_as(_destination_prev) || !next_destination.same_latlon_as(_next_destination_prev)) {
         _destination_prev = destination;
         _next_destination_prev = next_destination;
-        _shortest_path_ok = false;
+        abort_shortest_path();
     }
 
-    // calculate shortest path from current_loc to destination
+    // calculate shortest path from current_loc to destination. The search is spread
+    // across calls to bound the time spent in each call
     if (!_shortest_path_ok) {
-        _shortest_path_ok = calc_shortest_path(current_loc, destination, _error_id);
-        if (!_shortest_path_ok) {
+        bool search_done = false;
+        bool search_ok;
+        if (!_shortest_path_searching) {
+            search_ok = start_shortest_path(current_loc, destination, _error_id);
+            _shortest_path_searching = search_ok;
+        } else {
+            search_ok = continue_shortest_path(search_done, _error_id);
+        }
+        if (!search_ok) {
+            abort_shortest_path();
             dest_to_next_dest_clear = _dest_to_next_dest_clear = false;
             report_error(_error_id);
             Write_OADijkstra(DIJKSTRA_STATE_ERROR, (uint8_t)_error_id, 0, 0, destination, destination);
             return DIJKSTRA_STATE_ERROR;
         }
+        if (!search_done) {
+            if (!_keep_path_while_searching) {
+                Write_OADijkstra(DIJKSTRA_STATE_PROCESSING, 0, 0, 0, destination, destination);
+                return DIJKSTRA_STATE_PROCESSING;
+            }
+            // recalculating for the same destination, keep following the previous path
+            // until the new one is ready
+            return return_path_point(current_loc, destination, origin_new, destination_new, next_destination_new, dest_to_next_dest_clear);
+        }
+        _shortest_path_searching = false;
+        _keep_path_while_searching = false;
+        _shortest_path_ok = true;
+
         // start from 2nd point on path (first is the original origin)
         _path_idx_returned = 1;
 
@@ -181,6 +204,34 @@ AP_OADijkstra::AP_OADijkstra_State AP_OADijkstra::update(const Location &current
         }
     }
 
+    return return_path_point(current_loc, destination, origin_new, destination_new, next_destination_new, dest_to_next_dest_clear);
+}
+
+// stop any shortest path search in progress, a new search will be started by the next call to update
+void AP_OADijkstra::abort_shortest_path()
+{
+    _shortest_path_ok = false;
+    _shortest_path_searching = false;
+    _keep_path_while_searching = false;
+}
+
+// trigger Dijkstra's to recalculate shortest path based on current location
+// the current path continues to be returned until the new one has been found
+void AP_OADijkstra::recalculate_path()
+{
+    _keep_path_while_searching = _shortest_path_ok || _keep_path_while_searching;
+    _shortest_path_ok = false;
+    _shortest_path_searching = false;
+}
+
+// return the latest point on the calculated path
+AP_OADijkstra::AP_OADijkstra_State AP_OADijkstra::return_path_point(const Location &current_loc,
+                                                                    const Location &destination,
+                                                                    Location& origin_new,
+                                                                    Location& destination_new,
+                                                                    Location& next_destination_new,
+                                                                    bool& dest_to_next_dest_clear)
+{
     // path has been created, return latest point
     Vector2f dest_pos;
     const uint8_t path_length = get_shortest_path_numpoints() > 0 ? (get_shortest_path_numpoints() - 1) : 0;
@@ -786,7 +837,8 @@ void AP_OADijkstra::update_visible_node_distances(node_index curr_node_idx)
                 AP_OAVisGraph::OAItemID matching_id = (curr_node.id == item.id1) ? item.id2 : item.id1;
                 // find item's id in node array
                 node_index item_node_idx;
-                if (find_node_from_id(matching_id, item_node_idx)) {
+                // visited nodes already hold their shortest distance
+                if (find_node_from_id(matching_id, item_node_idx) && !_short_path_data[item_node_idx].visited) {
                     // if current node's distance + distance to item is less than item's current distance, update item's distance
                     const float dist_to_item_via_current_node = _short_path_data[curr_node_idx].distance_cm + item.distance_cm;
                     if (dist_to_item_via_current_node < _short_path_data[item_node_idx].distance_cm) {
@@ -846,18 +898,8 @@ bool AP_OADijkstra::find_closest_node_idx(node_index &node_idx) const
             // if node is already visited OR cannot be reached yet, we can't use it
             continue;
         }
-        // figure out the pos of this node
-        Vector2f node_pos;
-        float dist_with_heuristics = FLT_MAX;
-        if (convert_node_to_point(node.id, node_pos)) {
-            // heuristics is is simple Euclidean distance from the node to the destination
-            // This should be admissible, therefore optimal path is guaranteed
-            const float heuristics = (node_pos-_path_destination).length();
-            dist_with_heuristics = node.distance_cm + heuristics;
-        } else {
-            // shouldn't happen
-            return false;
-        }
+        // heuristic is calculated once per search in calc_shortest_path
+        const float dist_with_heuristics = node.distance_cm + node.heuristic_cm;
         if (dist_with_heuristics < lowest_dist) {
             // for NOW, this is the closest node
             lowest_idx = i;
@@ -873,11 +915,10 @@ bool AP_OADijkstra::find_closest_node_idx(node_index &node_idx) const
     return false;
 }
 
-// calculate shortest path from origin to destination
+// start calculating shortest path from origin to destination, continue_shortest_path completes the search
 // returns true on success.  returns false on failure and err_id is updated
 // requires these functions to have been run: create_inclusion_polygon_with_margin, create_exclusion_polygon_with_margin, create_exclusion_circle_with_margin, create_polygon_fence_visgraph
-// resulting path is stored in _shortest_path array as vector offsets from EKF origin
-bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &destination, AP_OADijkstra_Error &err_id)
+bool AP_OADijkstra::start_shortest_path(const Location &origin, const Location &destination, AP_OADijkstra_Error &err_id)
 {
     // convert origin and destination to offsets from EKF origin
     if (!origin.get_vector_xy_from_origin_NE_cm(_path_source) ||
@@ -902,14 +943,21 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
         return false;
     }
 
-    // add origin and destination (node_type, id, visited, distance_from_idx, distance_cm) to short_path_data array
-    _short_path_data[0] = {{AP_OAVisGraph::OATYPE_SOURCE, 0}, false, 0, 0};
-    _short_path_data[1] = {{AP_OAVisGraph::OATYPE_DESTINATION, 0}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX};
+    // add origin and destination (node_type, id, visited, distance_from_idx, distance_cm, heuristic_cm) to short_path_data array
+    _short_path_data[0] = {{AP_OAVisGraph::OATYPE_SOURCE, 0}, false, 0, 0, (_path_source - _path_destination).length()};
+    _short_path_data[1] = {{AP_OAVisGraph::OATYPE_DESTINATION, 0}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX, 0};
     _short_path_data_numpoints = 2;
 
-    // add all inclusion and exclusion fence points to short_path_data array (node_type, id, visited, distance_from_idx, distance_cm)
+    // add all inclusion and exclusion fence points to short_path_data array
+    // heuristic is the Euclidean distance from the node to the destination which never overestimates
+    // the remaining path length, so the first path found to the destination is the shortest
     for (uint8_t i=0; i<total_numpoints(); i++) {
-        _short_path_data[_short_path_data_numpoints++] = {{AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT, i}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX};
+        Vector2f point;
+        if (!get_point(i, point)) {
+            err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_COULD_NOT_FIND_PATH;
+            return false;
+        }
+        _short_path_data[_short_path_data_numpoints++] = {{AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT, i}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX, (point - _path_destination).length()};
     }
 
     // start algorithm from source point
@@ -929,7 +977,19 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
     // mark source node as visited
     _short_path_data[current_node_idx].visited = true;
 
+    return true;
+}
+
+// continue the search started by start_shortest_path, visiting at most OA_DIJKSTRA_SEARCH_NODES_PER_UPDATE nodes
+// search_done is set true once the search has finished and the resulting path is stored in the _path array
+// returns true on success.  returns false on failure and err_id is updated
+bool AP_OADijkstra::continue_shortest_path(bool &search_done, AP_OADijkstra_Error &err_id)
+{
+    search_done = false;
+
     // move current_node_idx to node with lowest distance
+    node_index current_node_idx;
+    uint8_t nodes_visited = 0;
     while (find_closest_node_idx(current_node_idx)) {
         node_index dest_node;
         // See if this next "closest" node is actually the destination
@@ -937,12 +997,18 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
             // We have discovered destination.. Don't bother with the rest of the graph
             break;
         }
+        if (nodes_visited >= OA_DIJKSTRA_SEARCH_NODES_PER_UPDATE) {
+            // continue from here on the next call
+            return true;
+        }
         // update distances to all neighbours of current node
         update_visible_node_distances(current_node_idx);
 
         // mark current node as visited
         _short_path_data[current_node_idx].visited = true;
+        nodes_visited++;
     }
+    search_done = true;
 
     // extract path starting from destination
     bool success = false;
@@ -978,6 +1044,7 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
     }
     // report error in case path not found
     if (!success) {
+        _path_numpoints = 0;
         err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_COULD_NOT_FIND_PATH;
     }
 
@@ -25,13 +25,17 @@ public:
     void set_fence_margin(float margin) { _polyfence_margin = MAX(margin, 0.0f); }
 
     // trigger Dijkstra's to recalculate shortest path based on current location 
-    void recalculate_path() { _shortest_path_ok = false; }
+    void recalculate_path();
+
+    // returns true if a shortest path search is in progress, update should be called again soon to complete it
+    bool search_in_progress() const { return _shortest_path_searching; }
 
     // update return status enum
     enum AP_OADijkstra_State : uint8_t {
         DIJKSTRA_STATE_NOT_REQUIRED = 0,
         DIJKSTRA_STATE_ERROR,
-        DIJKSTRA_STATE_SUCCESS
+        DIJKSTRA_STATE_SUCCESS,
+        DIJKSTRA_STATE_PROCESSING
     };
 
     // calculate a destination to avoid the polygon fence
@@ -123,11 +127,26 @@ private:
     // returns true on success.  returns false on failure and err_id is updated
     bool create_fence_visgraph(AP_OADijkstra_Error &err_id);
 
-    // calculate shortest path from origin to destination
+    // start calculating shortest path from origin to destination
     // returns true on success.  returns false on failure and err_id is updated
     // requires create_polygon_fence_with_margin and create_polygon_fence_visgraph to have been run
-    // resulting path is stored in _shortest_path array as vector offsets from EKF origin
-    bool calc_shortest_path(const Location &origin, const Location &destination, AP_OADijkstra_Error &err_id);
+    bool start_shortest_path(const Location &origin, const Location &destination, AP_OADijkstra_Error &err_id);
+
+    // continue the shortest path search, visiting a limited number of nodes so no single call takes too long
+    // search_done is set true once finished, the resulting path is then stored in _path array
+    // returns true on success.  returns false on failure and err_id is updated
+    bool continue_shortest_path(bool &search_done, AP_OADijkstra_Error &err_id);
+
+    // stop any shortest path search in progress and discard the current path
+    void abort_shortest_path();
+
+    // return the latest point on the calculated path, used by update
+    AP_OADijkstra_State return_path_point(const Location &current_loc,
+                                          const Location &destination,
+                                          Location& origin_new,
+                                          Location& destination_new,
+                                          Location& next_destination_new,
+                                          bool& dest_to_next_dest_clear);
 
     // shortest path state variables
     bool _inclusion_polygon_with_margin_ok;
@@ -135,6 +154,8 @@ private:
     bool _exclusion_circle_with_margin_ok;
     bool _polyfence_visgraph_ok;
     bool _shortest_path_ok;
+    bool _shortest_path_searching;      // true if a shortest path search has been started but not finished
+    bool _keep_path_while_searching;    // true if the previous path is returned while the new one is being searched for
 
     Location _destination_prev;     // destination of previous iterations (used to determine if path should be re-calculated)
     Location _next_destination_prev;// next_destination of previous iterations (used to determine if path should be re-calculated)
@@ -174,6 +195,7 @@ private:
         bool visited;                   // true if all this node's neighbour's distances have been updated
         node_index distance_from_idx;   // index into _short_path_data from where distance was updated (or 255 if not set)
         float distance_cm;              // distance from source (number is tentative until this node is the current node and/or visited = true)
+        float heuristic_cm;             // straight line distance from node to destination (A* heuristic)
     };
     AP_ExpandingArray<ShortPathNode> _short_path_data;
     node_index _short_path_data_numpoints;  // number of elements in _short_path_data array
@@ -186,7 +208,7 @@ private:
     // returns true if successful and node_idx is updated
     bool find_node_from_id(const AP_OAVisGraph::OAItemID &id, node_index &node_idx) const;
 
-    // find index of node with lowest tentative distance (ignore visited nodes)
+    // find index of node with lowest tentative distance plus heuristic (ignore visited nodes)
     // returns true if successful and node_idx argument is updated
     bool find_closest_node_idx(node_index &node_idx) const;
 
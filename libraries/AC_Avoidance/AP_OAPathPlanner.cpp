@@ -189,6 +189,19 @@ AP_OAPathPlanner::OAPathPlannerUsed AP_OAPathPlanner::map_bendytype_to_pathplann
     }
 }
 
+// returns true if Dijkstra's is being used and has a shortest path search underway
+bool AP_OAPathPlanner::dijkstra_search_in_progress() const
+{
+#if AP_FENCE_ENABLED
+    if ((_type != OA_PATHPLAN_DIJKSTRA) && (_type != OA_PATHPLAN_DJIKSTRA_BENDYRULER)) {
+        return false;
+    }
+    return (_oadijkstra != nullptr) && _oadijkstra->search_in_progress();
+#else
+    return false;
+#endif
+}
+
 // provides an alternative target location if path planning around obstacles is required
 // returns true and updates result_origin, result_destination, result_next_destination with an intermediate path
 // result_dest_to_next_dest_clear is set to true if the path from result_destination to result_next_destination is clear (only supported by Dijkstras)
@@ -277,7 +290,7 @@ void AP_OAPathPlanner::avoidance_thread()
         }
 
         const uint32_t now = AP_HAL::millis();
-        if (now - avoidance_latest_ms < OA_UPDATE_MS) {
+        if (now - avoidance_latest_ms < OA_UPDATE_MS && !dijkstra_search_in_progress()) {
             continue;
         }
         avoidance_latest_ms = now;
@@ -348,6 +361,9 @@ void AP_OAPathPlanner::avoidance_thread()
             case AP_OADijkstra::DIJKSTRA_STATE_SUCCESS:
                 res = OA_SUCCESS;
                 break;
+            case AP_OADijkstra::DIJKSTRA_STATE_PROCESSING:
+                res = OA_PROCESSING;
+                break;
             }
             path_planner_used = OAPathPlannerUsed::Dijkstras;
 #endif
@@ -395,6 +411,9 @@ void AP_OAPathPlanner::avoidance_thread()
             case AP_OADijkstra::DIJKSTRA_STATE_SUCCESS:
                 res = OA_SUCCESS;
                 break;
+            case AP_OADijkstra::DIJKSTRA_STATE_PROCESSING:
+                res = OA_PROCESSING;
+                break;
             }
             path_planner_used = OAPathPlannerUsed::Dijkstras;
 #endif
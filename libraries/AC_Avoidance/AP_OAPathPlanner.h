@@ -94,6 +94,9 @@ private:
     // helper function to map OABendyType to OAPathPlannerUsed
     OAPathPlannerUsed map_bendytype_to_pathplannerused(AP_OABendyRuler::OABendyType bendy_type);
 
+    // returns true if Dijkstra's is being used and has a shortest path search underway
+    bool dijkstra_search_in_progress() const;
+
     // an avoidance request from the navigation code
     struct avoidance_info {
         Location current_loc;
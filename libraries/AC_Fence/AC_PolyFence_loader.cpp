@@ -251,7 +251,7 @@ bool AC_PolyFence_loader::breached(const Location& loc, float& distance_outside_
         float distance;
         bool valid_distance = Polygon_closest_distance_point(boundary.points, boundary.count, scaled_pos, distance);
         distance *= 0.01f; // convert back to meters
-        if (Polygon_outside(pos, boundary.points_lla, boundary.count)) {
+        if (boundary.bounds.outside(pos) || Polygon_outside(pos, boundary.points_lla, boundary.count)) {
             num_inclusion_outside++;
             if (valid_distance) {
                 if (is_positive(distance_outside_fence)) {
@@ -268,6 +268,12 @@ bool AC_PolyFence_loader::breached(const Location& loc, float& distance_outside_
     // check we are outside each exclusion zone:
     for (uint8_t i=0; i<_num_loaded_exclusion_boundaries; i++) {
         const ExclusionBoundary &boundary = _loaded_exclusion_boundary[i];
+        if (boundary.bounds.outside(pos) &&
+            -boundary.bounds.distance_lower_bound_cm(scaled_pos, scaled_pos) * 0.01f <= distance_outside_fence) {
+            // we are outside this zone and further from it than from
+            // a zone already checked, so it can't change the result
+            continue;
+        }
         float distance;
         bool valid_distance = Polygon_closest_distance_point(boundary.points, boundary.count, scaled_pos, distance);
         distance *= 0.01f; // convert back to meters
@@ -784,6 +790,7 @@ bool AC_PolyFence_loader::load_from_storage()
                 storage_valid = false;
                 break;
             }
+            boundary.bounds.set(boundary.points, boundary.points_lla, boundary.count);
             _num_loaded_inclusion_boundaries++;
             break;
         }
@@ -803,6 +810,7 @@ bool AC_PolyFence_loader::load_from_storage()
                 storage_valid = false;
                 break;
             }
+            boundary.bounds.set(boundary.points, boundary.points_lla, boundary.count);
             _num_loaded_exclusion_boundaries++;
             break;
         }
@@ -940,6 +948,24 @@ Vector2f* AC_PolyFence_loader::get_inclusion_polygon(uint16_t index, uint16_t &n
     return boundary.points;
 }
 
+/// returns the bounding box of the specified exclusion polygon
+const AC_PolyFence_loader::PolygonBounds *AC_PolyFence_loader::get_exclusion_polygon_bounds(uint16_t index) const
+{
+    if (index >= _num_loaded_exclusion_boundaries) {
+        return nullptr;
+    }
+    return &_loaded_exclusion_boundary[index].bounds;
+}
+
+/// returns the bounding box of the specified inclusion polygon
+const AC_PolyFence_loader::PolygonBounds *AC_PolyFence_loader::get_inclusion_polygon_bounds(uint16_t index) const
+{
+    if (index >= _num_loaded_inclusion_boundaries) {
+        return nullptr;
+    }
+    return &_loaded_inclusion_boundary[index].bounds;
+}
+
 /// returns the specified exclusion circle
 /// circle center offsets in cm from EKF origin in NE frame, radius is in meters
 bool AC_PolyFence_loader::get_exclusion_circle(uint8_t index, Vector2f &center_pos_cm, float &radius) const
@@ -1698,6 +1724,8 @@ bool AC_PolyFence_loader::get_item(const uint16_t seq, AC_PolyFenceItem &item) {
 
 Vector2f* AC_PolyFence_loader::get_exclusion_polygon(uint16_t index, uint16_t &num_points) const { return nullptr; }
 Vector2f* AC_PolyFence_loader::get_inclusion_polygon(uint16_t index, uint16_t &num_points) const { return nullptr; }
+const AC_PolyFence_loader::PolygonBounds *AC_PolyFence_loader::get_exclusion_polygon_bounds(uint16_t index) const { return nullptr; }
+const AC_PolyFence_loader::PolygonBounds *AC_PolyFence_loader::get_inclusion_polygon_bounds(uint16_t index) const { return nullptr; }
 
 bool AC_PolyFence_loader::get_exclusion_circle(uint8_t index, Vector2f &center_pos_cm, float &radius) const { return false; }
 bool AC_PolyFence_loader::get_inclusion_circle(uint8_t index, Vector2f &center_pos_cm, float &radius) const { return false; }
@@ -1718,4 +1746,31 @@ bool AC_PolyFence_loader::get_return_point(Vector2l &ret) { return false; }
 #endif
 
 #endif // #if AC_FENCE_DUMMY_METHODS_ENABLED
+
+void AC_PolyFence_loader::PolygonBounds::set(const Vector2f *points, const Vector2l *points_lla, uint8_t count)
+{
+    min_cm = max_cm = points[0];
+    min_lla = max_lla = points_lla[0];
+    for (uint8_t i=1; i<count; i++) {
+        min_cm.x = MIN(min_cm.x, points[i].x);
+        min_cm.y = MIN(min_cm.y, points[i].y);
+        max_cm.x = MAX(max_cm.x, points[i].x);
+        max_cm.y = MAX(max_cm.y, points[i].y);
+        min_lla.x = MIN(min_lla.x, points_lla[i].x);
+        min_lla.y = MIN(min_lla.y, points_lla[i].y);
+        max_lla.x = MAX(max_lla.x, points_lla[i].x);
+        max_lla.y = MAX(max_lla.y, points_lla[i].y);
+    }
+}
+
+// distance between the bounding box of the segment and our box. As
+// the segment lies within its box and the edges within ours this is
+// never more than the true distance
+float AC_PolyFence_loader::PolygonBounds::distance_lower_bound_cm(const Vector2f &p1, const Vector2f &p2) const
+{
+    const float dx = MAX(MAX(min_cm.x - MAX(p1.x, p2.x), MIN(p1.x, p2.x) - max_cm.x), 0.0f);
+    const float dy = MAX(MAX(min_cm.y - MAX(p1.y, p2.y), MIN(p1.y, p2.y) - max_cm.y), 0.0f);
+    return norm(dx, dy);
+}
+
 #endif // AP_FENCE_ENABLED
@@ -71,6 +71,30 @@ public:
     uint16_t num_stored_items() const { return _eeprom_item_count; }
     bool get_item(const uint16_t seq, AC_PolyFenceItem &item) WARN_IF_UNUSED;
 
+    // axis-aligned bounding box of a loaded polygon. Points and paths
+    // clear of the box can skip the per-edge polygon tests
+    class PolygonBounds {
+    public:
+        Vector2f min_cm;    // offsets in cm from EKF origin in NE frame
+        Vector2f max_cm;
+        Vector2l min_lla;
+        Vector2l max_lla;
+
+        void set(const Vector2f *points, const Vector2l *points_lla, uint8_t count);
+
+        // true if the point is outside the box, and so outside the polygon
+        bool outside(const Vector2f &pos_cm) const {
+            return pos_cm.x < min_cm.x || pos_cm.x > max_cm.x || pos_cm.y < min_cm.y || pos_cm.y > max_cm.y;
+        }
+        bool outside(const Vector2l &pos_lla) const {
+            return pos_lla.x < min_lla.x || pos_lla.x > max_lla.x || pos_lla.y < min_lla.y || pos_lla.y > max_lla.y;
+        }
+
+        // lower bound on the distance in cm from the line segment p1-p2
+        // to any edge of the polygon, zero if the segment may touch the box
+        float distance_lower_bound_cm(const Vector2f &p1, const Vector2f &p2) const;
+    };
+
     ///
     /// exclusion polygons
     ///
@@ -82,6 +106,8 @@ public:
     /// returns pointer to array of exclusion polygon points and num_points is filled in with the number of points in the polygon
     /// points are offsets in cm from EKF origin in NE frame
     Vector2f* get_exclusion_polygon(uint16_t index, uint16_t &num_points) const;
+    // returns the bounding box of an exclusion polygon or nullptr if index is invalid
+    const PolygonBounds *get_exclusion_polygon_bounds(uint16_t index) const;
 
     /// return system time of last update to the exclusion polygon points
     uint32_t get_exclusion_polygon_update_ms() const {
@@ -99,6 +125,8 @@ public:
     /// returns pointer to array of inclusion polygon points and num_points is filled in with the number of points in the polygon
     /// points are offsets in cm from EKF origin in NE frame
     Vector2f* get_inclusion_polygon(uint16_t index, uint16_t &num_points) const;
+    // returns the bounding box of an inclusion polygon or nullptr if index is invalid
+    const PolygonBounds *get_inclusion_polygon_bounds(uint16_t index) const;
 
     /// return system time of last update to the inclusion polygon points
     uint32_t get_inclusion_polygon_update_ms() const {
@@ -306,6 +334,7 @@ private:
         Vector2f *points; // pointer into the _loaded_offsets_from_origin array
         Vector2l *points_lla; // pointer into the _loaded_points_lla array
         uint8_t count; // count of points in the boundary
+        PolygonBounds bounds;
     };
     InclusionBoundary *_loaded_inclusion_boundary;
 
@@ -316,6 +345,7 @@ private:
         Vector2f *points; // pointer into the _loaded_offsets_from_origin array
         Vector2l *points_lla; // pointer into the _loaded_points_lla_lla array
         uint8_t count; // count of points in the boundary
+        PolygonBounds bounds;
     };
     ExclusionBoundary *_loaded_exclusion_boundary;
 
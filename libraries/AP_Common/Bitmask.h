@@ -151,6 +151,22 @@ public:
         return -1;
     }
 
+    // return first bit set at or after start, or -1 if none set
+    int16_t next_set(uint16_t start) const {
+        if (start >= NUMBITS) {
+            return -1;
+        }
+        uint16_t word = start/32;
+        uint32_t w = bits[word] & (0xFFFFFFFFU << (start & 0x1f));
+        while (w == 0) {
+            if (++word >= NUMWORDS) {
+                return -1;
+            }
+            w = bits[word];
+        }
+        return word*32 + __builtin_ffs(w) - 1;
+    }
+
     // return number of bits available
     uint16_t size() const {
         return NUMBITS;
@@ -144,5 +144,38 @@ TEST(Bitmask, Assignment63) { bitmask_assignment<63>(); }
 TEST(Bitmask, Assignment64) { bitmask_assignment<64>(); }
 TEST(Bitmask, Assignment65) { bitmask_assignment<65>(); }
 
+template<int N>
+void bitmask_next_set(void)
+{
+    Bitmask<N> x;
+    EXPECT_EQ(-1, x.next_set(0));
+    x.set(0);
+    x.set(5);
+    x.set(31);
+    x.set(N-1);
+    EXPECT_EQ(0, x.next_set(0));
+    EXPECT_EQ(5, x.next_set(1));
+    EXPECT_EQ(5, x.next_set(5));
+    EXPECT_EQ(31, x.next_set(6));
+    EXPECT_EQ(N-1, x.next_set(32));
+    EXPECT_EQ(N-1, x.next_set(N-1));
+    EXPECT_EQ(-1, x.next_set(N));
+    x.clear(N-1);
+    EXPECT_EQ(-1, x.next_set(32));
+
+    // walking the set bits visits each one once
+    x.setall();
+    uint16_t count = 0;
+    for (int16_t i = x.next_set(0); i >= 0; i = x.next_set(i+1)) {
+        count++;
+    }
+    EXPECT_EQ(N, count);
+}
+
+TEST(Bitmask, NextSet33) { bitmask_next_set<33>(); }
+TEST(Bitmask, NextSet64) { bitmask_next_set<64>(); }
+TEST(Bitmask, NextSet65) { bitmask_next_set<65>(); }
+TEST(Bitmask, NextSet648) { bitmask_next_set<648>(); }
+
 AP_GTEST_PANIC()
 AP_GTEST_MAIN()
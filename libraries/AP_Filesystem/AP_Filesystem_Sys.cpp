@@ -36,6 +36,12 @@ struct SysFileList {
 static const SysFileList sysfs_file_list[] = {
     {"threads.txt"},
     {"tasks.txt"},
+#if AP_SCHEDULER_ENABLED && AP_SCHEDULER_TASK_HISTOGRAM_ENABLED
+    {"task_hist.txt"},
+#endif
+#if AP_SCHEDULER_ENABLED && AP_SCHEDULER_LOOP_TRACE_EVENTS
+    {"loop_trace.txt"},
+#endif
     {"dma.txt"},
     {"memory.txt"},
     {"uarts.txt"},
@@ -105,6 +111,16 @@ int AP_Filesystem_Sys::open(const char *fname, int flags, bool allow_absolute_pa
     if (strcmp(fname, "tasks.txt") == 0) {
         AP::scheduler().task_info(*r.str);
     }
+#if AP_SCHEDULER_TASK_HISTOGRAM_ENABLED
+    if (strcmp(fname, "task_hist.txt") == 0) {
+        AP::scheduler().task_hist_info(*r.str);
+    }
+#endif
+#if AP_SCHEDULER_LOOP_TRACE_EVENTS
+    if (strcmp(fname, "loop_trace.txt") == 0) {
+        AP::scheduler().loop_trace_info(*r.str);
+    }
+#endif
 #endif
     if (strcmp(fname, "dma.txt") == 0) {
         hal.util->dma_info(*r.str);
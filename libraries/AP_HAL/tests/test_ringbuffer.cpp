@@ -0,0 +1,111 @@
+#include <AP_gtest.h>
+#include <AP_HAL/HAL.h>
+#include <AP_HAL/utility/RingBuffer.h>
+
+#include <thread>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+TEST(ByteBuffer, WriteReadWrap)
+{
+    ByteBuffer buf(16);
+    uint8_t data[20];
+    for (uint8_t i=0; i<sizeof(data); i++) {
+        data[i] = i;
+    }
+
+    // one byte less than the size is usable
+    EXPECT_EQ(buf.write(data, sizeof(data)), 15U);
+    EXPECT_EQ(buf.available(), 15U);
+    EXPECT_EQ(buf.space(), 0U);
+
+    uint8_t out[20] {};
+    EXPECT_EQ(buf.read(out, 10), 10U);
+    for (uint8_t i=0; i<10; i++) {
+        EXPECT_EQ(out[i], i);
+    }
+
+    // write across the end of the buffer
+    EXPECT_EQ(buf.write(data, 8), 8U);
+    EXPECT_EQ(buf.available(), 13U);
+    EXPECT_EQ(buf.read(out, sizeof(out)), 13U);
+    for (uint8_t i=0; i<5; i++) {
+        EXPECT_EQ(out[i], i+10);
+    }
+    for (uint8_t i=0; i<8; i++) {
+        EXPECT_EQ(out[i+5], i);
+    }
+    EXPECT_TRUE(buf.is_empty());
+}
+
+TEST(ObjectBuffer, ReserveCommit)
+{
+    ObjectBuffer<uint32_t> buf(8);
+    uint32_t n = 0;
+    uint32_t *ptr = buf.reserve(n);
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(n, 8U);
+    for (uint32_t i=0; i<5; i++) {
+        ptr[i] = i;
+    }
+    // nothing is visible until committed
+    EXPECT_EQ(buf.available(), 0U);
+    EXPECT_TRUE(buf.commit(5));
+    EXPECT_EQ(buf.available(), 5U);
+    EXPECT_FALSE(buf.commit(4));
+
+    uint32_t v;
+    for (uint32_t i=0; i<5; i++) {
+        EXPECT_TRUE(buf.pop(v));
+        EXPECT_EQ(v, i);
+    }
+
+    // the reserved span stops at the end of the buffer
+    ptr = buf.reserve(n);
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(n, 4U);
+}
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+TEST(ObjectBuffer, SingleProducerSingleConsumer)
+{
+    const uint32_t count = 200000;
+    ObjectBuffer<uint32_t> buf(64);
+
+    std::thread producer([&buf, count]() {
+        uint32_t value = 0;
+        while (value < count) {
+            uint32_t n;
+            uint32_t *ptr = buf.reserve(n);
+            if (ptr == nullptr) {
+                std::this_thread::yield();
+                continue;
+            }
+            uint32_t i = 0;
+            for (; i<n && value<count; i++) {
+                ptr[i] = value++;
+            }
+            buf.commit(i);
+        }
+    });
+
+    uint32_t expected = 0;
+    uint32_t errors = 0;
+    while (expected < count) {
+        uint32_t v;
+        if (!buf.pop(v)) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (v != expected) {
+            errors++;
+        }
+        expected++;
+    }
+    producer.join();
+    EXPECT_EQ(errors, 0U);
+    EXPECT_TRUE(buf.is_empty());
+}
+#endif
+
+AP_GTEST_MAIN()
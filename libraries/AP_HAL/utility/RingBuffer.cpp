@@ -26,7 +26,8 @@ bool ByteBuffer::set_size(uint32_t _size)
         // resize not supported with external buffer
         return false;
     }
-    head = tail = 0;
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
     if (_size != size) {
         free(buf);
         buf = (uint8_t*)calloc(1, _size);
@@ -55,46 +56,60 @@ bool ByteBuffer::set_size_best(uint32_t _size)
     return false;
 }
 
+/*
+  The buffer is safe for a single reader and a single writer without
+  locking. The writer owns tail and the reader owns head. Each side
+  loads the index it does not own with acquire ordering, which pairs
+  with the release store made when the other side publishes, so data
+  written before a commit() is visible once the new tail is seen, and
+  space freed by advance() is only reused after the reader is done
+  with it. This avoids the full barriers of sequentially consistent
+  atomics on every access.
+ */
 uint32_t ByteBuffer::available(void) const
 {
-    /* use a copy on stack to avoid race conditions of @tail being updated by
-     * the writer thread */
-    uint32_t _tail = tail;
+    return available(head.load(std::memory_order_acquire), tail.load(std::memory_order_acquire));
+}
 
-    if (head > _tail) {
-        return size - head + _tail;
+uint32_t ByteBuffer::available(uint32_t _head, uint32_t _tail) const
+{
+    if (_head > _tail) {
+        return size - _head + _tail;
     }
-    return _tail - head;
+    return _tail - _head;
 }
 
 void ByteBuffer::clear(void)
 {
-    head = tail = 0;
+    head.store(0, std::memory_order_release);
+    tail.store(0, std::memory_order_release);
 }
 
 uint32_t ByteBuffer::space(void) const
+{
+    return space(head.load(std::memory_order_acquire), tail.load(std::memory_order_acquire));
+}
+
+uint32_t ByteBuffer::space(uint32_t _head, uint32_t _tail) const
 {
     if (size == 0) {
         return 0;
     }
 
-    /* use a copy on stack to avoid race conditions of @head being updated by
-     * the reader thread */
-    uint32_t _head = head;
     uint32_t ret = 0;
 
-    if (_head <= tail) {
+    if (_head <= _tail) {
         ret = size;
     }
 
-    ret += _head - tail - 1;
+    ret += _head - _tail - 1;
 
     return ret;
 }
 
 bool ByteBuffer::is_empty(void) const
 {
-    return head == tail;
+    return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
 }
 
 uint32_t ByteBuffer::write(const uint8_t *data, uint32_t len)
@@ -118,15 +133,16 @@ uint32_t ByteBuffer::write(const uint8_t *data, uint32_t len)
  */
 bool ByteBuffer::update(const uint8_t *data, uint32_t len)
 {
-    if (len > available()) {
+    const uint32_t _head = head.load(std::memory_order_relaxed);
+    if (len > available(_head, tail.load(std::memory_order_acquire))) {
         return false;
     }
     // perform as two memcpy calls
-    uint32_t n = size - head;
+    uint32_t n = size - _head;
     if (n > len) {
         n = len;
     }
-    memcpy(&buf[head], data, n);
+    memcpy(&buf[_head], data, n);
     data += n;
     if (len > n) {
         memcpy(&buf[0], data, len-n);
@@ -136,10 +152,11 @@ bool ByteBuffer::update(const uint8_t *data, uint32_t len)
 
 bool ByteBuffer::advance(uint32_t n)
 {
-    if (n > available()) {
+    const uint32_t _head = head.load(std::memory_order_relaxed);
+    if (n > available(_head, tail.load(std::memory_order_acquire))) {
         return false;
     }
-    head = (head + n) % size;
+    head.store((_head + n) % size, std::memory_order_release);
     return true;
 }
 
@@ -198,7 +215,8 @@ uint32_t ByteBuffer::peekbytes(uint8_t *data, uint32_t len)
 
 uint8_t ByteBuffer::reserve(ByteBuffer::IoVec iovec[2], uint32_t len)
 {
-    uint32_t n = space();
+    const uint32_t _tail = tail.load(std::memory_order_relaxed);
+    uint32_t n = space(head.load(std::memory_order_acquire), _tail);
 
     if (len > n) {
         len = n;
@@ -208,9 +226,9 @@ uint8_t ByteBuffer::reserve(ByteBuffer::IoVec iovec[2], uint32_t len)
         return 0;
     }
 
-    iovec[0].data = &buf[tail];
+    iovec[0].data = &buf[_tail];
 
-    n = size - tail;
+    n = size - _tail;
     if (len <= n) {
         iovec[0].len = len;
         return 1;
@@ -229,11 +247,13 @@ uint8_t ByteBuffer::reserve(ByteBuffer::IoVec iovec[2], uint32_t len)
  */
 bool ByteBuffer::commit(uint32_t len)
 {
-    if (len > space()) {
+    const uint32_t _tail = tail.load(std::memory_order_relaxed);
+    if (len > space(head.load(std::memory_order_acquire), _tail)) {
         return false; //Someone broke the agreement
     }
 
-    tail = (tail + len) % size;
+    // release so the reader sees the data before the new tail
+    tail.store((_tail + len) % size, std::memory_order_release);
     return true;
 }
 
@@ -265,16 +285,18 @@ bool ByteBuffer::read_byte(uint8_t *data)
  */
 const uint8_t *ByteBuffer::readptr(uint32_t &available_bytes)
 {
-    uint32_t _tail = tail;
-    available_bytes = (head > _tail) ? size - head : _tail - head;
+    const uint32_t _head = head.load(std::memory_order_relaxed);
+    const uint32_t _tail = tail.load(std::memory_order_acquire);
+    available_bytes = (_head > _tail) ? size - _head : _tail - _head;
 
-    return available_bytes ? &buf[head] : nullptr;
+    return available_bytes ? &buf[_head] : nullptr;
 }
 
 int16_t ByteBuffer::peek(uint32_t ofs) const
 {
-    if (ofs >= available()) {
+    const uint32_t _head = head.load(std::memory_order_relaxed);
+    if (ofs >= available(_head, tail.load(std::memory_order_acquire))) {
         return -1;
     }
-    return buf[(head+ofs)%size];
+    return buf[(_head+ofs)%size];
 }
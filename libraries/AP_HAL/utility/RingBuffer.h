@@ -8,6 +8,9 @@
 
 /*
  * Circular buffer of bytes.
+ *
+ * A single reader and a single writer may use the buffer concurrently
+ * without locking. Any other pattern of access needs a lock.
  */
 class ByteBuffer {
 public:
@@ -95,11 +98,15 @@ public:
     bool commit(uint32_t len);
 
 private:
+    // available and space for a snapshot of the read and write pointers
+    uint32_t available(uint32_t _head, uint32_t _tail) const;
+    uint32_t space(uint32_t _head, uint32_t _tail) const;
+
     uint8_t *buf;
     uint32_t size;
 
-    std::atomic<uint32_t> head{0}; // where to read data
-    std::atomic<uint32_t> tail{0}; // where to write data
+    std::atomic<uint32_t> head{0}; // where to read data, owned by the reader
+    std::atomic<uint32_t> tail{0}; // where to write data, owned by the writer
 
     bool external_buf;
 };
@@ -271,6 +278,30 @@ public:
         return buffer->update((uint8_t*)&object, sizeof(T));
     }
 
+    /*
+      return a pointer to the first contiguous array of free objects so
+      a writer can fill several objects in place, then make them
+      available to the reader with commit(). Return nullptr if there
+      is no space. Not available in ObjectBuffer_TS as the objects are
+      written outside any lock
+     */
+    T *reserve(uint32_t &n) {
+        ByteBuffer::IoVec vec[2];
+        if (buffer->reserve(vec, buffer->space()) == 0 || vec[0].len < sizeof(T)) {
+            return nullptr;
+        }
+        n = vec[0].len / sizeof(T);
+        #pragma GCC diagnostic push
+        #pragma GCC diagnostic ignored "-Wcast-align"
+        return (T *)vec[0].data;
+        #pragma GCC diagnostic pop
+    }
+
+    // make n objects written after reserve() available to the reader
+    bool commit(uint32_t n) {
+        return buffer->commit(n * sizeof(T));
+    }
+
 private:
     ByteBuffer *buffer = nullptr;
     bool external_buf = true;
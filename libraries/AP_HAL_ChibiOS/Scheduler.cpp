@@ -296,6 +296,10 @@ void Scheduler::reboot(bool hold_in_bootloader)
     }
 #endif
 
+    // write out any storage changes still being held back. This must
+    // be before the unmount as storage may be on the microSD card
+    hal.storage->flush();
+
 #if HAL_LOGGING_ENABLED
     //stop logging
     if (AP_Logger::get_singleton()) {
@@ -241,6 +241,7 @@ void Storage::write_block(uint16_t loc, const void *src, size_t n)
         WITH_SEMAPHORE(sem);
         memcpy(&_buffer[loc], src, n);
         _mark_dirty(loc, n);
+        _last_write_ms = AP_HAL::millis();
     }
 }
 
@@ -254,8 +255,23 @@ void Storage::_timer_tick(void)
         return;
     }
 
+#ifdef STORAGE_FLASH_PAGE
+    if (_initialisedType == StorageBackend::Flash) {
+        // let a burst of writes settle first, each flash write uses
+        // up sector space which has to be erased eventually
+        const uint32_t now_ms = AP_HAL::millis();
+        if (!_flush_requested &&
+            now_ms - _last_write_ms < CH_STORAGE_FLASH_COALESCE_MS &&
+            now_ms - _last_empty_ms < CH_STORAGE_FLASH_COALESCE_MAX_MS) {
+            return;
+        }
+    }
+#endif
+
     // write out the first dirty line. We don't write more
-    // than one to keep the latency of this call to a minimum
+    // than one to keep the latency of this call to a minimum,
+    // except on flash where a short run of adjacent dirty lines
+    // is written as one block
     uint16_t i;
     for (i=0; i<CH_STORAGE_NUM_LINES; i++) {
         if (_dirty_mask.get(i)) {
@@ -266,11 +282,19 @@ void Storage::_timer_tick(void)
         // this shouldn't be possible
         return;
     }
+    uint16_t num_lines = 1;
+    if (_initialisedType == StorageBackend::Flash) {
+        while (num_lines < CH_STORAGE_FLASH_RUN_LINES &&
+               i+num_lines < CH_STORAGE_NUM_LINES &&
+               _dirty_mask.get(i+num_lines)) {
+            num_lines++;
+        }
+    }
 
     {
-        // take a copy of the line we are writing with a semaphore held
+        // take a copy of the lines we are writing with a semaphore held
         WITH_SEMAPHORE(sem);
-        memcpy(tmpline, &_buffer[CH_STORAGE_LINE_SIZE*i], CH_STORAGE_LINE_SIZE);
+        memcpy(tmpline, &_buffer[CH_STORAGE_LINE_SIZE*i], CH_STORAGE_LINE_SIZE*num_lines);
     }
 
     bool write_ok = false;
@@ -302,7 +326,7 @@ void Storage::_timer_tick(void)
 #ifdef STORAGE_FLASH_PAGE
     if (_initialisedType == StorageBackend::Flash) {
         // save to storage backend
-        if (_flash_write(i)) {
+        if (_flash_write(i, num_lines)) {
             write_ok = true;
         }
     }
@@ -316,12 +340,34 @@ void Storage::_timer_tick(void)
         // were writing it, in which case we should not mark it
         // clean. If it matches then we know we can mark the line as
         // clean
-        if (memcmp(tmpline, &_buffer[CH_STORAGE_LINE_SIZE*i], CH_STORAGE_LINE_SIZE) == 0) {
-            _dirty_mask.clear(i);
+        for (uint16_t n=0; n<num_lines; n++) {
+            const uint16_t ofs = CH_STORAGE_LINE_SIZE*n;
+            if (memcmp(&tmpline[ofs], &_buffer[CH_STORAGE_LINE_SIZE*i+ofs], CH_STORAGE_LINE_SIZE) == 0) {
+                _dirty_mask.clear(i+n);
+            }
         }
     }
 }
 
+/*
+  write out all dirty lines without waiting for writes to settle. This
+  is called before a reboot so recently saved data is not lost
+ */
+void Storage::flush(void)
+{
+    if (_initialisedType == StorageBackend::None) {
+        return;
+    }
+    _flush_requested = true;
+    // the storage thread writes one run of lines per tick
+    hal.scheduler->expect_delay_ms(500);
+    for (uint16_t i=0; i<500 && !_dirty_mask.empty(); i++) {
+        hal.scheduler->delay(1);
+    }
+    hal.scheduler->expect_delay_ms(0);
+    _flush_requested = false;
+}
+
 /*
   load all data from flash
  */
@@ -345,13 +391,13 @@ void Storage::_flash_load(void)
 }
 
 /*
-  write one storage line. This also updates _dirty_mask.
+  write a run of storage lines. This also updates _dirty_mask.
 */
-bool Storage::_flash_write(uint16_t line)
+bool Storage::_flash_write(uint16_t line, uint16_t num_lines)
 {
 #ifdef STORAGE_FLASH_PAGE
     EXPECT_DELAY_MS(1);
-    return _flash.write(line*CH_STORAGE_LINE_SIZE, CH_STORAGE_LINE_SIZE);
+    return _flash.write(line*CH_STORAGE_LINE_SIZE, CH_STORAGE_LINE_SIZE*num_lines);
 #else
     return false;
 #endif
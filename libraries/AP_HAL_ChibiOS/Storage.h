@@ -47,6 +47,30 @@
 static_assert(CH_STORAGE_SIZE % CH_STORAGE_LINE_SIZE == 0,
               "Storage is not multiple of line size");
 
+#ifdef STORAGE_FLASH_PAGE
+// adjacent dirty lines are written to flash as a single run of up to
+// this many lines, which costs fewer block headers than a write per line
+#ifndef CH_STORAGE_FLASH_RUN_LINES
+#if CH_STORAGE_LINE_SIZE >= 64
+#define CH_STORAGE_FLASH_RUN_LINES 1
+#else
+#define CH_STORAGE_FLASH_RUN_LINES (64/CH_STORAGE_LINE_SIZE)
+#endif
+#endif
+
+// flash writes are held back until there have been no new writes for
+// CH_STORAGE_FLASH_COALESCE_MS, so a burst of saves to the same line is
+// only written once, but never for more than CH_STORAGE_FLASH_COALESCE_MAX_MS
+#ifndef CH_STORAGE_FLASH_COALESCE_MS
+#define CH_STORAGE_FLASH_COALESCE_MS 50
+#endif
+#ifndef CH_STORAGE_FLASH_COALESCE_MAX_MS
+#define CH_STORAGE_FLASH_COALESCE_MAX_MS 250
+#endif
+#else
+#define CH_STORAGE_FLASH_RUN_LINES 1
+#endif
+
 /*
   on boards with 8k sector sizes we double up to treat pairs of sectors as one
  */
@@ -62,6 +86,7 @@ public:
     void write_block(uint16_t dst, const void* src, size_t n) override;
 
     void _timer_tick(void) override;
+    void flush(void) override;
     bool healthy(void) override;
     bool get_storage_ptr(void *&ptr, size_t &size) override;
 
@@ -80,7 +105,7 @@ private:
     uint8_t _buffer[CH_STORAGE_SIZE] __attribute__((aligned(4)));
     Bitmask<CH_STORAGE_NUM_LINES> _dirty_mask;
     HAL_Semaphore sem;
-    uint8_t tmpline[CH_STORAGE_LINE_SIZE];
+    uint8_t tmpline[CH_STORAGE_LINE_SIZE*CH_STORAGE_FLASH_RUN_LINES];
 
     bool _flash_write_data(uint8_t sector, uint32_t offset, const uint8_t *data, uint16_t length);
     bool _flash_read_data(uint8_t sector, uint32_t offset, uint8_t *data, uint16_t length);
@@ -90,6 +115,8 @@ private:
     bool _flash_failed;
     uint32_t _last_re_init_ms;
     uint32_t _last_empty_ms;
+    uint32_t _last_write_ms;
+    bool _flush_requested;
 
 #ifdef STORAGE_FLASH_PAGE
     AP_FlashStorage _flash{_buffer,
@@ -105,7 +132,7 @@ private:
 #endif
 
     void _flash_load(void);
-    bool _flash_write(uint16_t line);
+    bool _flash_write(uint16_t line, uint16_t num_lines);
 
 #if HAL_WITH_RAMTRON
     AP_RAMTRON fram;
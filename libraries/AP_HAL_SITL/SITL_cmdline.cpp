@@ -117,6 +117,7 @@ void SITL_State::_usage(void)
            "\t--start-time TIMESTR     set simulation start time in UNIX timestamp\n"
            "\t--sysid ID               set MAV_SYSID\n"
            "\t--slave number           set the number of JSON slaves\n"
+           "\t--lockstep number        share the simulation clock with this many instances\n"
         );
 }
 
@@ -244,6 +245,7 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
     char *autotest_dir = nullptr;
     _fg_address = "127.0.0.1";
     const char* config = "";
+    uint8_t lockstep_instances = 0;
 
     const int BASE_PORT = 5760;
     const int RCIN_PORT = 5501;
@@ -303,6 +305,7 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         CMDLINE_START_TIME,
         CMDLINE_SYSID,
         CMDLINE_SLAVE,
+        CMDLINE_LOCKSTEP,
 #if STORAGE_USE_FLASH
         CMDLINE_SET_STORAGE_FLASH_ENABLED,
 #endif
@@ -363,6 +366,7 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         {"start-time",      true,   0, CMDLINE_START_TIME},
         {"sysid",           true,   0, CMDLINE_SYSID},
         {"slave",           true,   0, CMDLINE_SLAVE},
+        {"lockstep",        true,   0, CMDLINE_LOCKSTEP},
 #if STORAGE_USE_FLASH
         {"set-storage-flash-enabled", true,   0, CMDLINE_SET_STORAGE_FLASH_ENABLED},
 #endif
@@ -572,6 +576,20 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
 #endif  // AP_SIM_JSON_MASTER_ENABLED
             break;
         }
+        case CMDLINE_LOCKSTEP: {
+#if AP_SIM_LOCKSTEP_ENABLED
+            const int32_t max_instances = SITL::Lockstep::MAX_INSTANCES;
+#else
+            const int32_t max_instances = UINT8_MAX;
+#endif
+            const int32_t instances = atoi(gopt.optarg);
+            if (instances < 2 || instances > max_instances) {
+                fprintf(stderr, "--lockstep needs between 2 and %d instances\n", int(max_instances));
+                exit(1);
+            }
+            lockstep_instances = instances;
+            break;
+        }
         default:
             _usage();
             exit(1);
@@ -610,6 +628,16 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
             sitl_model->set_interface_ports(simulator_address, simulator_port_in, simulator_port_out);
             sitl_model->set_speedup(speedup);
             sitl_model->set_instance(_instance);
+            if (lockstep_instances > 0) {
+#if AP_SIM_LOCKSTEP_ENABLED
+                if (!sitl_model->set_lockstep(lockstep_instances)) {
+                    exit(1);
+                }
+#else
+                printf("Lockstep not supported on this build\n");
+                exit(1);
+#endif
+            }
             sitl_model->set_autotest_dir(autotest_dir);
             sitl_model->set_config(config);
             break;
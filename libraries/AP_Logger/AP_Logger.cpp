@@ -202,6 +202,15 @@ const AP_Param::GroupInfo AP_Logger::var_info[] = {
     // @RebootRequired: True
     AP_GROUPINFO("_MAX_FILES", 12, AP_Logger, _params.max_log_files, MAX_LOG_FILES),
 
+#if AP_LOGGER_COMPRESSION_ENABLED && HAL_LOGGING_FILESYSTEM_ENABLED
+    // @Param: _FILE_COMPRESS
+    // @DisplayName: Compress log files
+    // @Description: When enabled, new logs written by the File backend are compressed in independent blocks, reducing their size on the card. Logs downloaded over MAVLink are decompressed on the fly and Replay reads them directly. Log files copied straight off the card can be decompressed with Tools/scripts/decompress_log.py. Takes effect when the next log is started.
+    // @Values: 0:Disabled,1:Enabled
+    // @User: Advanced
+    AP_GROUPINFO("_FILE_COMPRESS", 13, AP_Logger, _params.file_compress, 0),
+#endif
+
     AP_GROUPEND
 };
 
@@ -349,6 +349,9 @@ public:
         AP_Float blk_ratemax;
         AP_Float disarm_ratemax;
         AP_Int16 max_log_files;
+#if AP_LOGGER_COMPRESSION_ENABLED && HAL_LOGGING_FILESYSTEM_ENABLED
+        AP_Int8 file_compress;
+#endif
     } _params;
 
     const struct LogStructure *structure(uint16_t num) const;
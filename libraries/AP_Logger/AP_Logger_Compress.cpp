@@ -0,0 +1,238 @@
+#include "AP_Logger_Compress.h"
+
+#if AP_LOGGER_COMPRESSION_ENABLED
+
+#include <string.h>
+#include <AP_Math/AP_Math.h>
+
+// LZ4 block format limits
+#define LZ4_MINMATCH     4
+#define LZ4_LASTLITERALS 5   // last 5 bytes of a block are always literals
+#define LZ4_MFLIMIT      12  // last match must start this far from the end
+#define LZ4_MAX_OFFSET   65535
+
+static inline uint32_t read32(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/*
+  write a LZ4 length extension, returning false if it would not fit
+ */
+static bool put_length(uint8_t *dst, uint32_t &op, uint32_t dst_size, uint32_t len)
+{
+    while (len >= 255) {
+        if (op >= dst_size) {
+            return false;
+        }
+        dst[op++] = 255;
+        len -= 255;
+    }
+    if (op >= dst_size) {
+        return false;
+    }
+    dst[op++] = len;
+    return true;
+}
+
+/*
+  write one LZ4 sequence. A match_len of zero gives the final
+  literal-only sequence
+ */
+static bool put_sequence(uint8_t *dst, uint32_t &op, uint32_t dst_size,
+                         const uint8_t *literals, uint32_t lit_len,
+                         uint16_t offset, uint32_t match_len)
+{
+    if (op >= dst_size) {
+        return false;
+    }
+    const uint32_t ml = match_len > 0 ? match_len - LZ4_MINMATCH : 0;
+    dst[op++] = (MIN(lit_len, 15U) << 4) | MIN(ml, 15U);
+    if (lit_len >= 15 && !put_length(dst, op, dst_size, lit_len - 15)) {
+        return false;
+    }
+    if (op + lit_len > dst_size) {
+        return false;
+    }
+    memcpy(&dst[op], literals, lit_len);
+    op += lit_len;
+    if (match_len == 0) {
+        return true;
+    }
+    if (op + 2 > dst_size) {
+        return false;
+    }
+    dst[op++] = offset & 0xFF;
+    dst[op++] = offset >> 8;
+    if (ml >= 15 && !put_length(dst, op, dst_size, ml - 15)) {
+        return false;
+    }
+    return true;
+}
+
+/*
+  greedy single pass LZ4 compressor. Log data is dominated by
+  repeated message headers and slowly changing fields, which a simple
+  hash of the last position of each 4 byte sequence finds well enough
+ */
+uint32_t AP_Logger_Compress::compress(const uint8_t *src, uint32_t len, uint8_t *dst, uint32_t dst_size)
+{
+    memset(hash_table, 0, sizeof(hash_table));
+
+    uint32_t op = 0;
+    uint32_t anchor = 0;
+    uint32_t ip = 0;
+
+    if (len > LZ4_MFLIMIT) {
+        const uint32_t match_start_limit = len - LZ4_MFLIMIT;
+        const uint32_t match_end_limit = len - LZ4_LASTLITERALS;
+        while (ip < match_start_limit) {
+            const uint32_t seq = read32(&src[ip]);
+            const uint32_t h = (seq * 2654435761U) >> (32 - HASH_BITS);
+            const uint32_t ref = hash_table[h];
+            hash_table[h] = ip;
+            if (ref >= ip || ip - ref > LZ4_MAX_OFFSET || read32(&src[ref]) != seq) {
+                ip++;
+                continue;
+            }
+            uint32_t match_len = LZ4_MINMATCH;
+            while (ip + match_len < match_end_limit && src[ref+match_len] == src[ip+match_len]) {
+                match_len++;
+            }
+            if (!put_sequence(dst, op, dst_size, &src[anchor], ip - anchor, ip - ref, match_len)) {
+                return 0;
+            }
+            ip += match_len;
+            anchor = ip;
+        }
+    }
+
+    if (!put_sequence(dst, op, dst_size, &src[anchor], len - anchor, 0, 0)) {
+        return 0;
+    }
+    return op;
+}
+
+const uint8_t *AP_Logger_Compress::compress_block(const uint8_t *src, uint16_t len, uint16_t &frame_len)
+{
+    if (len > BLOCK_MAX) {
+        len = BLOCK_MAX;
+    }
+    block_header &hdr = *(block_header *)frame;
+    hdr.magic = MAGIC;
+    hdr.raw_len = len;
+
+    // only keep the compressed form if it is smaller
+    uint32_t comp_len = compress(src, len, &frame[sizeof(hdr)], len > 1 ? len - 1 : 0);
+    if (comp_len == 0) {
+        memcpy(&frame[sizeof(hdr)], src, len);
+        comp_len = len;
+    }
+    hdr.comp_len = comp_len;
+    frame_len = sizeof(hdr) + comp_len;
+    return frame;
+}
+
+bool AP_Logger_Compress::valid_header(const block_header &hdr)
+{
+    return hdr.magic == MAGIC &&
+        hdr.raw_len > 0 &&
+        hdr.raw_len <= BLOCK_MAX &&
+        hdr.comp_len <= hdr.raw_len;
+}
+
+bool AP_Logger_Compress::valid_trailer(const block_trailer &trailer, uint32_t file_size)
+{
+    return trailer.magic == TRAILER_MAGIC &&
+        trailer.comp_size >= sizeof(block_header) &&
+        trailer.comp_size + sizeof(trailer) <= file_size;
+}
+
+bool AP_Logger_Compress::is_compressed(const uint8_t *data, uint32_t len)
+{
+    if (len < sizeof(block_header)) {
+        return false;
+    }
+    block_header hdr;
+    memcpy(&hdr, data, sizeof(hdr));
+    return valid_header(hdr);
+}
+
+bool AP_Logger_Compress::decode_block(const block_header &hdr, const uint8_t *payload, uint8_t *dst)
+{
+    if (hdr.comp_len == hdr.raw_len) {
+        memcpy(dst, payload, hdr.raw_len);
+        return true;
+    }
+    return decompress(payload, hdr.comp_len, dst, hdr.raw_len) == hdr.raw_len;
+}
+
+int32_t AP_Logger_Compress::decompress(const uint8_t *src, uint32_t src_len, uint8_t *dst, uint32_t dst_size)
+{
+    uint32_t ip = 0;
+    uint32_t op = 0;
+
+    while (ip < src_len) {
+        const uint8_t token = src[ip++];
+
+        uint32_t lit_len = token >> 4;
+        if (lit_len == 15) {
+            uint8_t b;
+            do {
+                if (ip >= src_len) {
+                    return -1;
+                }
+                b = src[ip++];
+                lit_len += b;
+            } while (b == 255);
+        }
+        if (lit_len > src_len - ip || lit_len > dst_size - op) {
+            return -1;
+        }
+        memcpy(&dst[op], &src[ip], lit_len);
+        ip += lit_len;
+        op += lit_len;
+
+        if (ip == src_len) {
+            // final sequence has no match
+            break;
+        }
+
+        if (src_len - ip < 2) {
+            return -1;
+        }
+        const uint16_t offset = src[ip] | (src[ip+1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) {
+            return -1;
+        }
+
+        uint32_t match_len = token & 0x0F;
+        if (match_len == 15) {
+            uint8_t b;
+            do {
+                if (ip >= src_len) {
+                    return -1;
+                }
+                b = src[ip++];
+                match_len += b;
+            } while (b == 255);
+        }
+        match_len += LZ4_MINMATCH;
+        if (match_len > dst_size - op) {
+            return -1;
+        }
+        // byte copy as the match may overlap the output
+        const uint8_t *match = &dst[op - offset];
+        for (uint32_t i=0; i<match_len; i++) {
+            dst[op+i] = match[i];
+        }
+        op += match_len;
+    }
+
+    return op;
+}
+
+#endif // AP_LOGGER_COMPRESSION_ENABLED
@@ -0,0 +1,88 @@
+/*
+  streaming block compression for logs
+
+  A compressed log is a sequence of independent frames, each a
+  block_header followed by the block compressed in the LZ4 block
+  format (or stored as-is if it did not compress). As every frame can
+  be decoded on its own a log cut short by a power loss is still
+  readable up to the last complete frame.
+ */
+#pragma once
+
+#include "AP_Logger_config.h"
+
+#if AP_LOGGER_COMPRESSION_ENABLED
+
+#include <stdint.h>
+#include <AP_Common/AP_Common.h>
+
+class AP_Logger_Compress
+{
+public:
+    // "LZ4B" in file byte order
+    static constexpr uint32_t MAGIC = 0x42345A4C;
+
+    // largest uncompressed block in a frame
+    static constexpr uint16_t BLOCK_MAX = 4096;
+
+    struct PACKED block_header {
+        uint32_t magic;
+        uint16_t raw_len;   // uncompressed length
+        uint16_t comp_len;  // payload length, equal to raw_len if stored
+    };
+
+    static constexpr uint16_t FRAME_MAX = sizeof(block_header) + BLOCK_MAX;
+
+    // "LZ4E" in file byte order
+    static constexpr uint32_t TRAILER_MAGIC = 0x45345A4C;
+
+    // written after the last frame of a log which was closed cleanly
+    struct PACKED block_trailer {
+        uint32_t magic;
+        uint32_t raw_size;  // uncompressed size of the log
+        uint32_t comp_size; // file offset where the frames end
+    };
+
+    /*
+      compress up to BLOCK_MAX bytes into a frame. Returns a pointer
+      to the frame, which is valid until the next call, and sets
+      frame_len
+     */
+    const uint8_t *compress_block(const uint8_t *src, uint16_t len, uint16_t &frame_len);
+
+    // return true if a frame header is plausible
+    static bool valid_header(const block_header &hdr);
+
+    // return true if a trailer read from the end of a file of
+    // file_size bytes is valid
+    static bool valid_trailer(const block_trailer &trailer, uint32_t file_size);
+
+    // return true if data starts with a compressed frame
+    static bool is_compressed(const uint8_t *data, uint32_t len);
+
+    /*
+      decode the payload of a frame into dst, which must have space
+      for hdr.raw_len bytes. Returns false on corrupt data
+     */
+    static bool decode_block(const block_header &hdr, const uint8_t *payload, uint8_t *dst);
+
+    /*
+      decompress a LZ4 block. Returns the number of bytes written to
+      dst or -1 on corrupt data
+     */
+    static int32_t decompress(const uint8_t *src, uint32_t src_len, uint8_t *dst, uint32_t dst_size);
+
+private:
+    static constexpr uint8_t HASH_BITS = 12;
+
+    // LZ4 compresses into at most dst_size bytes, returning 0 if the
+    // output would not fit
+    uint32_t compress(const uint8_t *src, uint32_t len, uint8_t *dst, uint32_t dst_size);
+
+    // position of the last occurrence of each hashed 4 byte sequence
+    uint16_t hash_table[1U<<HASH_BITS];
+
+    uint8_t frame[FRAME_MAX];
+};
+
+#endif // AP_LOGGER_COMPRESSION_ENABLED
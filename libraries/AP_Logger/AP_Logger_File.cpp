@@ -33,6 +33,10 @@
 #include <GCS_MAVLink/GCS.h>
 #include <stdio.h>
 
+#if AP_LOGGER_FILE_WRITEBACK_SIZE
+#include <fcntl.h>
+#endif
+
 
 extern const AP_HAL::HAL& hal;
 
@@ -522,8 +526,13 @@ uint32_t AP_Logger_File::_get_log_size(const uint16_t log_num)
         if (_write_filename != nullptr && strcmp(_write_filename, fname) == 0) {
             // it is the file we are currently writing
             free(fname);
+#if AP_LOGGER_COMPRESSION_ENABLED
+            const uint32_t size = _write_compressed ? _write_raw_offset : _write_offset;
+#else
+            const uint32_t size = _write_offset;
+#endif
             write_fd_semaphore.give();
-            return _write_offset;
+            return size;
         }
         write_fd_semaphore.give();
     }
@@ -533,10 +542,211 @@ uint32_t AP_Logger_File::_get_log_size(const uint16_t log_num)
         free(fname);
         return 0;
     }
+#if AP_LOGGER_COMPRESSION_ENABLED
+    // report compressed logs with their uncompressed size as that is
+    // what a download will return
+    const uint32_t size = download_size(fname, log_num, st.st_size);
+    free(fname);
+    return size;
+#else
     free(fname);
     return st.st_size;
+#endif
+}
+
+#if AP_LOGGER_COMPRESSION_ENABLED
+/*
+  get the cache entry for the download size of a log, or nullptr if
+  it can't be cached. Entries start zeroed, which is correct for an
+  empty log. Must be called with _log_size_sem held
+ */
+AP_Logger_File::log_size_entry *AP_Logger_File::log_size_cache_entry(uint16_t log_num)
+{
+    const uint16_t max_logs = _front.get_max_num_logs();
+    if (log_num == 0 || log_num > max_logs) {
+        return nullptr;
+    }
+    if (_log_size_cache_len != max_logs) {
+        delete[] _log_size_cache;
+        _log_size_cache_len = 0;
+        _log_size_cache = NEW_NOTHROW log_size_entry[max_logs];
+        if (_log_size_cache == nullptr) {
+            return nullptr;
+        }
+        _log_size_cache_len = max_logs;
+    }
+    return &_log_size_cache[log_num-1];
+}
+
+/*
+  read the trailer of a compressed log, returning false if it has none
+ */
+bool AP_Logger_File::read_trailer(int fd, uint32_t file_size, AP_Logger_Compress::block_trailer &trailer)
+{
+    return file_size >= sizeof(trailer) &&
+        AP::FS().lseek(fd, file_size - sizeof(trailer), SEEK_SET) != (off_t)-1 &&
+        AP::FS().read(fd, &trailer, sizeof(trailer)) == sizeof(trailer) &&
+        AP_Logger_Compress::valid_trailer(trailer, file_size);
+}
+
+/*
+  get the size of a log as a download returns it, which for a
+  compressed log is its uncompressed size. Plain logs are recognised
+  from their first bytes. Compressed logs closed cleanly end with a
+  trailer holding the size. Logs cut short have their frames walked
+  once and a trailer appended, so the walk is not repeated. Results
+  are cached per log, so listing logs does not reopen them
+ */
+uint32_t AP_Logger_File::download_size(const char *fname, uint16_t log_num, uint32_t file_size)
+{
+    {
+        WITH_SEMAPHORE(_log_size_sem);
+        const log_size_entry *entry = log_size_cache_entry(log_num);
+        if (entry != nullptr && entry->file_size == file_size) {
+            return entry->size;
+        }
+    }
+
+    uint32_t size = file_size;
+    AP_Logger_Compress::block_header hdr;
+    EXPECT_DELAY_MS(3000);
+    const int fd = file_size >= sizeof(hdr) ? AP::FS().open(fname, O_RDONLY) : -1;
+    if (fd != -1) {
+        AP_Logger_Compress::block_trailer trailer;
+        if (AP::FS().read(fd, &hdr, sizeof(hdr)) != sizeof(hdr) ||
+            !AP_Logger_Compress::valid_header(hdr)) {
+            // a plain log
+            AP::FS().close(fd);
+        } else if (read_trailer(fd, file_size, trailer)) {
+            AP::FS().close(fd);
+            size = trailer.raw_size;
+        } else {
+            // no trailer, the log was cut short
+            uint32_t ofs = 0;
+            size = 0;
+            while (ofs + sizeof(hdr) <= file_size) {
+                if (AP::FS().lseek(fd, ofs, SEEK_SET) == (off_t)-1 ||
+                    AP::FS().read(fd, &hdr, sizeof(hdr)) != sizeof(hdr) ||
+                    !AP_Logger_Compress::valid_header(hdr) ||
+                    ofs + sizeof(hdr) + hdr.comp_len > file_size) {
+                    // end of the log or a truncated final frame
+                    break;
+                }
+                size += hdr.raw_len;
+                ofs += sizeof(hdr) + hdr.comp_len;
+            }
+            AP::FS().close(fd);
+            if (!hal.util->get_soft_armed() &&
+                append_trailer(fname, size, ofs)) {
+                file_size += sizeof(trailer);
+            }
+        }
+    }
+
+    WITH_SEMAPHORE(_log_size_sem);
+    log_size_entry *entry = log_size_cache_entry(log_num);
+    if (entry != nullptr) {
+        entry->file_size = file_size;
+        entry->size = size;
+    }
+    return size;
+}
+
+/*
+  append a trailer to a compressed log which was cut short. comp_size
+  is the end of the last complete frame, readers ignore anything
+  between it and the trailer
+ */
+bool AP_Logger_File::append_trailer(const char *fname, uint32_t raw_size, uint32_t comp_size)
+{
+    // never touch the log being written
+    WITH_SEMAPHORE(write_fd_semaphore);
+    if (_write_fd != -1 && _write_filename != nullptr && strcmp(_write_filename, fname) == 0) {
+        return false;
+    }
+    const int fd = AP::FS().open(fname, O_WRONLY|O_APPEND);
+    if (fd == -1) {
+        return false;
+    }
+    AP_Logger_Compress::block_trailer trailer;
+    trailer.magic = AP_Logger_Compress::TRAILER_MAGIC;
+    trailer.raw_size = raw_size;
+    trailer.comp_size = comp_size;
+    const bool ret = AP::FS().write(fd, &trailer, sizeof(trailer)) == sizeof(trailer);
+    AP::FS().close(fd);
+    return ret;
 }
 
+/*
+  read from a compressed log at an uncompressed offset. Downloads are
+  sequential so normally only the next frame needs to be decoded
+ */
+int16_t AP_Logger_File::read_compressed(uint32_t ofs, uint16_t len, uint8_t *data)
+{
+    uint16_t ret = 0;
+    while (ret < len) {
+        if (ofs >= _read_lz.block_ofs && ofs < _read_lz.block_ofs + _read_lz.block_len) {
+            const uint16_t n = MIN(uint32_t(len - ret), _read_lz.block_ofs + _read_lz.block_len - ofs);
+            memcpy(&data[ret], &_read_lz.block[ofs - _read_lz.block_ofs], n);
+            ret += n;
+            ofs += n;
+            continue;
+        }
+        if (ofs < _read_lz.raw_ofs) {
+            // going backwards, start again from the first frame
+            _read_lz.file_ofs = 0;
+            _read_lz.raw_ofs = 0;
+        }
+        AP_Logger_Compress::block_header hdr;
+        if (_read_lz.file_ofs + sizeof(hdr) > _read_lz.end_ofs ||
+            AP::FS().lseek(_read_fd, _read_lz.file_ofs, SEEK_SET) == (off_t)-1 ||
+            AP::FS().read(_read_fd, &hdr, sizeof(hdr)) != sizeof(hdr) ||
+            !AP_Logger_Compress::valid_header(hdr)) {
+            // end of the log
+            break;
+        }
+        const uint32_t block_ofs = _read_lz.raw_ofs;
+        _read_lz.file_ofs += sizeof(hdr) + hdr.comp_len;
+        _read_lz.raw_ofs += hdr.raw_len;
+        if (ofs >= _read_lz.raw_ofs) {
+            // skip this frame without reading the payload
+            continue;
+        }
+        if (AP::FS().read(_read_fd, _read_lz.payload, hdr.comp_len) != hdr.comp_len ||
+            !AP_Logger_Compress::decode_block(hdr, _read_lz.payload, _read_lz.block)) {
+            // truncated or corrupt final frame
+            break;
+        }
+        _read_lz.block_ofs = block_ofs;
+        _read_lz.block_len = hdr.raw_len;
+    }
+    return ret;
+}
+
+void AP_Logger_File::free_read_buffers(void)
+{
+    delete[] _read_lz.payload;
+    delete[] _read_lz.block;
+    _read_lz.payload = nullptr;
+    _read_lz.block = nullptr;
+}
+
+/*
+  end a compressed log with a trailer holding its uncompressed size so
+  log listing does not need to walk the frames
+ */
+void AP_Logger_File::write_trailer(int fd)
+{
+    AP_Logger_Compress::block_trailer trailer;
+    trailer.magic = AP_Logger_Compress::TRAILER_MAGIC;
+    trailer.raw_size = _write_raw_offset;
+    trailer.comp_size = _write_offset;
+    if (AP::FS().write(fd, &trailer, sizeof(trailer)) == sizeof(trailer)) {
+        _write_offset += sizeof(trailer);
+    }
+}
+#endif // AP_LOGGER_COMPRESSION_ENABLED
+
 uint32_t AP_Logger_File::_get_log_time(const uint16_t log_num)
 {
     char *fname = _log_file_name(log_num);
@@ -613,6 +823,10 @@ int16_t AP_Logger_File::get_log_data(const uint16_t list_entry, const uint16_t p
         }
         stop_logging();
         EXPECT_DELAY_MS(3000);
+#if AP_LOGGER_COMPRESSION_ENABLED
+        struct stat st;
+        const uint32_t file_size = AP::FS().stat(fname, &st) == 0 ? st.st_size : 0;
+#endif
         _read_fd = AP::FS().open(fname, O_RDONLY);
         if (_read_fd == -1) {
             _open_error_ms = AP_HAL::millis();
@@ -627,9 +841,41 @@ int16_t AP_Logger_File::get_log_data(const uint16_t list_entry, const uint16_t p
         free(fname);
         _read_offset = 0;
         _read_fd_log_num = log_num;
+#if AP_LOGGER_COMPRESSION_ENABLED
+        uint8_t magic[sizeof(AP_Logger_Compress::block_header)];
+        const ssize_t n = AP::FS().read(_read_fd, magic, sizeof(magic));
+        _read_lz.compressed = n > 0 && AP_Logger_Compress::is_compressed(magic, n);
+        // frames end at the trailer's comp_size if the log has one
+        _read_lz.end_ofs = UINT32_MAX;
+        AP_Logger_Compress::block_trailer trailer;
+        if (_read_lz.compressed && read_trailer(_read_fd, file_size, trailer)) {
+            _read_lz.end_ofs = trailer.comp_size;
+        }
+        AP::FS().lseek(_read_fd, 0, SEEK_SET);
+        _read_lz.file_ofs = 0;
+        _read_lz.raw_ofs = 0;
+        _read_lz.block_ofs = 0;
+        _read_lz.block_len = 0;
+        if (_read_lz.compressed && _read_lz.block == nullptr) {
+            _read_lz.payload = NEW_NOTHROW uint8_t[AP_Logger_Compress::BLOCK_MAX];
+            _read_lz.block = NEW_NOTHROW uint8_t[AP_Logger_Compress::BLOCK_MAX];
+            if (_read_lz.payload == nullptr || _read_lz.block == nullptr) {
+                free_read_buffers();
+                AP::FS().close(_read_fd);
+                _read_fd = -1;
+                return -1;
+            }
+        }
+#endif
     }
     uint32_t ofs = page * (uint32_t)LOGGER_PAGE_SIZE + offset;
 
+#if AP_LOGGER_COMPRESSION_ENABLED
+    if (_read_lz.compressed) {
+        return read_compressed(ofs, len, data);
+    }
+#endif
+
     if (ofs != _read_offset) {
         if (AP::FS().lseek(_read_fd, ofs, SEEK_SET) == (off_t)-1) {
             AP::FS().close(_read_fd);
@@ -651,6 +897,9 @@ void AP_Logger_File::end_log_transfer()
         AP::FS().close(_read_fd);
         _read_fd = -1;
     }
+#if AP_LOGGER_COMPRESSION_ENABLED
+    free_read_buffers();
+#endif
 }
 
 /*
@@ -716,6 +965,12 @@ void AP_Logger_File::stop_logging(void)
     if (_write_fd != -1) {
         int fd = _write_fd;
         _write_fd = -1;
+#if AP_LOGGER_COMPRESSION_ENABLED
+        // only with the semaphore held is _write_offset at a frame boundary
+        if (have_sem && _write_compressed) {
+            write_trailer(fd);
+        }
+#endif
         AP::FS().close(fd);
     }
     if (have_sem) {
@@ -830,6 +1085,16 @@ void AP_Logger_File::start_new_log(void)
     EXPECT_DELAY_MS(3000);
     _write_fd = AP::FS().open(_write_filename, O_WRONLY|O_CREAT|O_TRUNC);
     _cached_oldest_log = 0;
+#if AP_LOGGER_COMPRESSION_ENABLED
+    {
+        // the cached size was for the log being overwritten
+        WITH_SEMAPHORE(_log_size_sem);
+        log_size_entry *entry = log_size_cache_entry(log_num);
+        if (entry != nullptr) {
+            *entry = {};
+        }
+    }
+#endif
 
     if (_write_fd == -1) {
         write_fd_semaphore.give();
@@ -845,6 +1110,16 @@ void AP_Logger_File::start_new_log(void)
     _last_write_ms = AP_HAL::millis();
     _open_error_ms = 0;
     _write_offset = 0;
+#if AP_LOGGER_COMPRESSION_ENABLED
+    if (_front._params.file_compress != 0 && _compressor == nullptr) {
+        _compressor = NEW_NOTHROW AP_Logger_Compress;
+    }
+    _write_compressed = _front._params.file_compress != 0 && _compressor != nullptr;
+    _write_raw_offset = 0;
+#endif
+#if AP_LOGGER_FILE_WRITEBACK_SIZE
+    _writeback_offset = 0;
+#endif
     _writebuf.clear();
     write_fd_semaphore.give();
 
@@ -969,9 +1244,15 @@ void AP_Logger_File::io_timer(void)
     const uint8_t *head = _writebuf.readptr(size);
     nbytes = MIN(nbytes, size);
 
+#if AP_LOGGER_COMPRESSION_ENABLED
+    const bool compressed = _write_compressed;
+#else
+    const bool compressed = false;
+#endif
+
 #if !AP_FILESYSTEM_LITTLEFS_ENABLED
     // try to align writes on a 512 byte boundary to avoid filesystem reads
-    if ((nbytes + _write_offset) % 512 != 0) {
+    if (!compressed && (nbytes + _write_offset) % 512 != 0) {
         uint32_t ofs = (nbytes + _write_offset) % 512;
         if (ofs < nbytes) {
             nbytes -= ofs;
@@ -987,13 +1268,31 @@ void AP_Logger_File::io_timer(void)
         return;
     }
 
+    const uint8_t *wptr = head;
+    uint32_t wlen = nbytes;
     uint32_t bytes_until_fsync = AP::FS().bytes_until_fsync(_write_fd);
-    if (bytes_until_fsync > 0 && nbytes > bytes_until_fsync) {
+    if (compressed) {
+#if AP_LOGGER_COMPRESSION_ENABLED
+        // frames are written whole, so sync after the frame which
+        // crosses the fsync boundary
+        nbytes = MIN(nbytes, uint32_t(AP_Logger_Compress::BLOCK_MAX));
+        uint16_t frame_len;
+        wptr = _compressor->compress_block(head, nbytes, frame_len);
+        wlen = frame_len;
+#endif
+    } else if (bytes_until_fsync > 0 && nbytes > bytes_until_fsync) {
         nbytes = bytes_until_fsync; // write exactly enough to sync
+        wlen = nbytes;
     }
 
-    ssize_t nwritten = AP::FS().write(_write_fd, head, nbytes);
+    ssize_t nwritten = AP::FS().write(_write_fd, wptr, wlen);
     last_io_operation = "";
+    if (compressed && nwritten > 0 && uint32_t(nwritten) != wlen) {
+        // a partial frame would corrupt the rest of the log, drop it
+        // and try the whole frame again
+        AP::FS().lseek(_write_fd, _write_offset, SEEK_SET);
+        nwritten = 0;
+    }
     if (nwritten <= 0) {
         if (errno == ENOSPC) {
             DEV_PRINTF("Out of space for logging\n");
@@ -1015,15 +1314,27 @@ void AP_Logger_File::io_timer(void)
         _last_write_failed = false;
         _last_write_ms = tnow;
         _write_offset += nwritten;
-        _writebuf.advance(nwritten);
+        if (compressed) {
+#if AP_LOGGER_COMPRESSION_ENABLED
+            _write_raw_offset += nbytes;
+#endif
+            _writebuf.advance(nbytes);
+        } else {
+            _writebuf.advance(nwritten);
+        }
 
-        // we know nwritten > 0 so we won't sync if bytes_until_fsync == 0
-        if ((uint32_t)nwritten == bytes_until_fsync) {
+        if (bytes_until_fsync > 0 && (uint32_t)nwritten >= bytes_until_fsync) {
             last_io_operation = "fsync";
             AP::FS().fsync(_write_fd);
             last_io_operation = "";
         }
 
+#if AP_LOGGER_FILE_WRITEBACK_SIZE
+        if (_write_offset - _writeback_offset >= AP_LOGGER_FILE_WRITEBACK_SIZE) {
+            start_writeback();
+        }
+#endif
+
 #if AP_RTC_ENABLED && CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS
         // ChibiOS does not update mtime on writes, so if we opened
         // without knowing the time we should update it later
@@ -1040,6 +1351,31 @@ void AP_Logger_File::io_timer(void)
     write_fd_semaphore.give();
 }
 
+#if AP_LOGGER_FILE_WRITEBACK_SIZE
+/*
+  ask the kernel to start writing the latest block of the log to the
+  card without waiting for it. The block before that was started on
+  the previous call, so it has normally completed by now; wait for it
+  so the amount of dirty data stays bounded, then drop it from the
+  page cache as we will not read it again. Called with
+  write_fd_semaphore held
+ */
+void AP_Logger_File::start_writeback(void)
+{
+    const uint32_t len = AP_LOGGER_FILE_WRITEBACK_SIZE;
+    last_io_operation = "writeback";
+    sync_file_range(_write_fd, _writeback_offset, len, SYNC_FILE_RANGE_WRITE);
+    if (_writeback_offset >= len) {
+        const uint32_t prev_offset = _writeback_offset - len;
+        sync_file_range(_write_fd, prev_offset, len,
+                        SYNC_FILE_RANGE_WAIT_BEFORE|SYNC_FILE_RANGE_WRITE|SYNC_FILE_RANGE_WAIT_AFTER);
+        posix_fadvise(_write_fd, prev_offset, len, POSIX_FADV_DONTNEED);
+    }
+    last_io_operation = "";
+    _writeback_offset += len;
+}
+#endif // AP_LOGGER_FILE_WRITEBACK_SIZE
+
 bool AP_Logger_File::io_thread_alive() const
 {
     if (!hal.scheduler->is_system_initialized()) {
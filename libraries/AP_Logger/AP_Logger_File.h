@@ -10,6 +10,7 @@
 
 #include <AP_HAL/utility/RingBuffer.h>
 #include "AP_Logger_Backend.h"
+#include "AP_Logger_Compress.h"
 
 #if HAL_LOGGING_FILESYSTEM_ENABLED
 
@@ -21,6 +22,20 @@
 #endif
 #endif
 
+/*
+  on Linux, start kernel writeback of the log every this many bytes
+  and drop older written data from the page cache. Without this dirty
+  pages build up until the kernel throttles a write() call for tens of
+  milliseconds while it flushes them to a slow SD card
+ */
+#ifndef AP_LOGGER_FILE_WRITEBACK_SIZE
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+#define AP_LOGGER_FILE_WRITEBACK_SIZE (256*1024UL)
+#else
+#define AP_LOGGER_FILE_WRITEBACK_SIZE 0
+#endif
+#endif
+
 class AP_Logger_File : public AP_Logger_Backend
 {
 public:
@@ -114,6 +129,49 @@ private:
     const uint16_t _writebuf_chunk = HAL_LOGGER_WRITE_CHUNK_SIZE;
     uint32_t _last_write_time;
 
+#if AP_LOGGER_COMPRESSION_ENABLED
+    // is the log being written compressed? _write_offset is then the
+    // compressed size and _write_raw_offset the logged size
+    bool _write_compressed;
+    uint32_t _write_raw_offset;
+    AP_Logger_Compress *_compressor;
+    void write_trailer(int fd);
+
+    // decompression state for log download
+    struct {
+        bool compressed;
+        uint8_t *payload;   // compressed block being read
+        uint8_t *block;     // decompressed block
+        uint32_t file_ofs;  // file offset of next frame
+        uint32_t raw_ofs;   // uncompressed offset of next frame
+        uint32_t block_ofs; // uncompressed offset of block
+        uint32_t end_ofs;   // file offset where the frames end
+        uint16_t block_len;
+    } _read_lz;
+    int16_t read_compressed(uint32_t ofs, uint16_t len, uint8_t *data);
+    void free_read_buffers(void);
+
+    // size a download of each log returns, indexed by log_num-1 and
+    // valid while the file size matches
+    struct log_size_entry {
+        uint32_t file_size;
+        uint32_t size;
+    };
+    log_size_entry *_log_size_cache;
+    uint16_t _log_size_cache_len;
+    HAL_Semaphore _log_size_sem;
+    log_size_entry *log_size_cache_entry(uint16_t log_num);
+    uint32_t download_size(const char *fname, uint16_t log_num, uint32_t file_size);
+    bool read_trailer(int fd, uint32_t file_size, AP_Logger_Compress::block_trailer &trailer);
+    bool append_trailer(const char *fname, uint32_t raw_size, uint32_t comp_size);
+#endif
+
+#if AP_LOGGER_FILE_WRITEBACK_SIZE
+    // offset up to which background writeback has been requested
+    uint32_t _writeback_offset;
+    void start_writeback(void);
+#endif
+
     /* construct a file name given a log number. Caller must free. */
     char *_log_file_name(const uint16_t log_num) const;
     char *_lastlog_file_name() const;
@@ -47,6 +47,11 @@
 
 #endif
 
+// optional LZ4 block compression of file backend logs
+#ifndef AP_LOGGER_COMPRESSION_ENABLED
+#define AP_LOGGER_COMPRESSION_ENABLED (HAL_LOGGING_ENABLED && (HAL_MEM_CLASS >= HAL_MEM_CLASS_1000))
+#endif
+
 #ifndef HAL_LOGGER_FILE_CONTENTS_ENABLED
 #define HAL_LOGGER_FILE_CONTENTS_ENABLED HAL_LOGGING_FILESYSTEM_ENABLED && !AP_FILESYSTEM_LITTLEFS_ENABLED
 #endif
@@ -595,6 +595,15 @@ struct PACKED log_STAK {
     char name[16];
 };
 
+struct PACKED log_TaskHist {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint8_t task_index;
+    char name[16];
+    uint16_t jitter_us;
+    uint16_t hist[10];
+};
+
 struct PACKED log_File {
     LOG_PACKET_HEADER;
     char filename[16];
@@ -1094,6 +1103,23 @@ struct PACKED log_VER {
 // @Field: Free: free stack
 // @Field: Name: thread name
 
+// @LoggerMessage: TSKH
+// @Description: Scheduler task run time histogram since the last message
+// @Field: TimeUS: Time since system startup
+// @Field: I: task index
+// @Field: Name: task name
+// @Field: Jit: spread of task start times within the main loop
+// @Field: H0: runs shorter than 16us
+// @Field: H1: runs of 16us to 32us
+// @Field: H2: runs of 32us to 64us
+// @Field: H3: runs of 64us to 128us
+// @Field: H4: runs of 128us to 256us
+// @Field: H5: runs of 256us to 512us
+// @Field: H6: runs of 512us to 1024us
+// @Field: H7: runs of 1024us to 2048us
+// @Field: H8: runs of 2048us to 4096us
+// @Field: H9: runs of 4096us or longer
+
 // @LoggerMessage: FILE
 // @Description: File data
 // @Field: FileName: File name
@@ -1252,6 +1278,8 @@ LOG_STRUCTURE_FROM_VISUALODOM \
     LOG_STRUCTURE_FROM_AC_ATTITUDECONTROL,                              \
     { LOG_STAK_MSG, sizeof(log_STAK), \
       "STAK", "QBBHHN", "TimeUS,Id,Pri,Total,Free,Name", "s#----", "F-----", true }, \
+    { LOG_TSKH_MSG, sizeof(log_TaskHist), \
+      "TSKH", "QBNHHHHHHHHHHH", "TimeUS,I,Name,Jit,H0,H1,H2,H3,H4,H5,H6,H7,H8,H9", "s#-s----------", "F--F----------", true }, \
     { LOG_FILE_MSG, sizeof(log_File), \
       "FILE",   "NIBZ",       "FileName,Offset,Length,Data", "----", "----" }, \
 LOG_STRUCTURE_FROM_AIS \
@@ -1348,6 +1376,7 @@ enum LogMessages : uint8_t {
     LOG_RCOUT3_MSG,
     LOG_IDS_FROM_FENCE,
     LOG_IDS_FROM_HAL,
+    LOG_TSKH_MSG,
 
     _LOG_LAST_MSG_
 };
@@ -0,0 +1,109 @@
+#include <AP_gtest.h>
+#include <AP_HAL/HAL.h>
+#include <AP_Logger/AP_Logger_Compress.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if AP_LOGGER_COMPRESSION_ENABLED
+
+static AP_Logger_Compress compressor;
+
+// compress and decode a block, checking it round trips
+static uint16_t round_trip(const uint8_t *data, uint16_t len)
+{
+    uint16_t frame_len;
+    const uint8_t *frame = compressor.compress_block(data, len, frame_len);
+    AP_Logger_Compress::block_header hdr;
+    memcpy(&hdr, frame, sizeof(hdr));
+    EXPECT_TRUE(AP_Logger_Compress::is_compressed(frame, frame_len));
+    EXPECT_EQ(hdr.raw_len, len);
+    EXPECT_EQ(frame_len, sizeof(hdr) + hdr.comp_len);
+
+    uint8_t out[AP_Logger_Compress::BLOCK_MAX];
+    EXPECT_TRUE(AP_Logger_Compress::decode_block(hdr, &frame[sizeof(hdr)], out));
+    EXPECT_EQ(memcmp(data, out, len), 0);
+    return hdr.comp_len;
+}
+
+TEST(LoggerCompress, LogData)
+{
+    // repeated messages with slowly changing fields
+    uint8_t data[AP_Logger_Compress::BLOCK_MAX];
+    for (uint16_t i=0; i<sizeof(data); i+=16) {
+        const uint8_t msg[16] { 0xA3, 0x95, 30, uint8_t(i>>4), uint8_t(i>>12), 0, 0, 0,
+                                1, 2, 3, 4, 0, 0, uint8_t(i%7), 0 };
+        memcpy(&data[i], msg, sizeof(msg));
+    }
+    EXPECT_LT(round_trip(data, sizeof(data)), sizeof(data)/2);
+}
+
+TEST(LoggerCompress, Incompressible)
+{
+    uint8_t data[1000];
+    uint32_t x = 1;
+    for (auto &b : data) {
+        x = x * 1103515245 + 12345;
+        b = x >> 24;
+    }
+    // stored as-is rather than expanded
+    EXPECT_EQ(round_trip(data, sizeof(data)), sizeof(data));
+
+    // blocks too short to hold a match
+    EXPECT_EQ(round_trip(data, 12), 12);
+    EXPECT_EQ(round_trip(data, 1), 1);
+}
+
+TEST(LoggerCompress, Decompress)
+{
+    // "abc" then a 9 byte match at offset 3, then 5 final literals
+    const uint8_t block[] { 0x35, 'a', 'b', 'c', 3, 0, 0x50, 'x', 'y', 'z', 'z', 'y' };
+    uint8_t out[32];
+    ASSERT_EQ(AP_Logger_Compress::decompress(block, sizeof(block), out, sizeof(out)), 17);
+    EXPECT_EQ(memcmp(out, "abcabcabcabcxyzzy", 17), 0);
+
+    // output too small, truncated input and a match before the start
+    EXPECT_EQ(AP_Logger_Compress::decompress(block, sizeof(block), out, 16), -1);
+    EXPECT_EQ(AP_Logger_Compress::decompress(block, 5, out, sizeof(out)), -1);
+    const uint8_t bad_offset[] { 0x10, 'a', 2, 0, 0x00 };
+    EXPECT_EQ(AP_Logger_Compress::decompress(bad_offset, sizeof(bad_offset), out, sizeof(out)), -1);
+}
+
+TEST(LoggerCompress, Header)
+{
+    AP_Logger_Compress::block_header hdr { AP_Logger_Compress::MAGIC, 100, 50 };
+    EXPECT_TRUE(AP_Logger_Compress::valid_header(hdr));
+    hdr.comp_len = 101;
+    EXPECT_FALSE(AP_Logger_Compress::valid_header(hdr));
+    hdr.comp_len = 50;
+    hdr.magic = 0;
+    EXPECT_FALSE(AP_Logger_Compress::valid_header(hdr));
+
+    // an uncompressed log starts with a message header
+    const uint8_t log_start[] { 0xA3, 0x95, 0x80, 0x80, 0x59, 0x46, 0x4D, 0x54 };
+    EXPECT_FALSE(AP_Logger_Compress::is_compressed(log_start, sizeof(log_start)));
+}
+
+TEST(LoggerCompress, Trailer)
+{
+    AP_Logger_Compress::block_trailer trailer { AP_Logger_Compress::TRAILER_MAGIC, 5000, 1200 };
+    EXPECT_TRUE(AP_Logger_Compress::valid_trailer(trailer, 1200 + sizeof(trailer)));
+
+    // a log cut short has a partial frame before its trailer
+    EXPECT_TRUE(AP_Logger_Compress::valid_trailer(trailer, 1300 + sizeof(trailer)));
+
+    // frames can't end past the trailer, or frame data
+    EXPECT_FALSE(AP_Logger_Compress::valid_trailer(trailer, 1100 + sizeof(trailer)));
+    trailer.magic = AP_Logger_Compress::MAGIC;
+    EXPECT_FALSE(AP_Logger_Compress::valid_trailer(trailer, 1200 + sizeof(trailer)));
+
+    // frame walkers stop at the trailer
+    AP_Logger_Compress::block_header hdr;
+    trailer.magic = AP_Logger_Compress::TRAILER_MAGIC;
+    memcpy(&hdr, &trailer, sizeof(hdr));
+    EXPECT_FALSE(AP_Logger_Compress::valid_header(hdr));
+}
+
+#endif // AP_LOGGER_COMPRESSION_ENABLED
+
+AP_GTEST_PANIC()
+AP_GTEST_MAIN()
@@ -82,6 +82,10 @@ void AP_Mission::init()
     if (_storage.size() >= AP_MISSION_EEPROM_COMMAND_SIZE+4) {
         _commands_max = (_storage.size()-4U) / AP_MISSION_EEPROM_COMMAND_SIZE;
     }
+
+#if AP_MISSION_CMD_CACHE_SIZE > 0
+    init_cmd_cache();
+#endif
     if (_cmd_total.get() > _commands_max) {
         // wipe mission if storage not available, but don't save. This allows sdcard error to be fixed and reboot
         _cmd_total.set(0);
@@ -832,6 +836,17 @@ bool AP_Mission::read_cmd_from_storage(uint16_t index, Mission_Command& cmd) con
         return false;
     }
 
+#if AP_MISSION_CMD_CACHE_SIZE > 0
+    Mission_Command *cached = nullptr;
+    if (_cmd_cache != nullptr) {
+        cached = &_cmd_cache[index % _cmd_cache_size];
+        if (cached->index == index) {
+            cmd = *cached;
+            return true;
+        }
+    }
+#endif
+
     // ensure all bytes of cmd are zeroed
     cmd = {};
 
@@ -890,10 +905,39 @@ bool AP_Mission::read_cmd_from_storage(uint16_t index, Mission_Command& cmd) con
     // set command's index to it's position in eeprom
     cmd.index = index;
 
+#if AP_MISSION_CMD_CACHE_SIZE > 0
+    if (cached != nullptr) {
+        *cached = cmd;
+    }
+#endif
+
     // return success
     return true;
 }
 
+#if AP_MISSION_CMD_CACHE_SIZE > 0
+/// init_cmd_cache - allocate and empty the decoded command cache
+void AP_Mission::init_cmd_cache(void)
+{
+    WITH_SEMAPHORE(_rsem);
+    if (_cmd_cache == nullptr) {
+        const uint16_t size = MIN(_commands_max, uint16_t(AP_MISSION_CMD_CACHE_SIZE));
+        if (size == 0) {
+            return;
+        }
+        _cmd_cache = NEW_NOTHROW Mission_Command[size];
+        if (_cmd_cache == nullptr) {
+            // missions are read from storage without a cache
+            return;
+        }
+        _cmd_cache_size = size;
+    }
+    for (uint16_t i=0; i<_cmd_cache_size; i++) {
+        _cmd_cache[i].index = AP_MISSION_CMD_INDEX_NONE;
+    }
+}
+#endif
+
 bool AP_Mission::stored_in_location(uint16_t id)
 {
     switch (id) {
@@ -960,6 +1004,17 @@ bool AP_Mission::write_cmd_to_storage(uint16_t index, const Mission_Command& cmd
         memcpy(packed.bytes, &cmd.content, 12);
     }
 
+#if AP_MISSION_CMD_CACHE_SIZE > 0
+    // the next read decodes the command from storage again so the
+    // cache holds exactly what was stored
+    if (_cmd_cache != nullptr) {
+        Mission_Command &cached = _cmd_cache[index % _cmd_cache_size];
+        if (cached.index == index) {
+            cached.index = AP_MISSION_CMD_INDEX_NONE;
+        }
+    }
+#endif
+
     // calculate where in storage the command should be placed
     uint16_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
 
@@ -34,6 +34,19 @@
 #endif
 #endif
 
+// maximum number of decoded commands cached in RAM, 0 to disable. The
+// cache holds the whole mission when it has at least num_commands_max()
+// entries, boards with RAM to spare can set this in hwdef to do so
+#ifndef AP_MISSION_CMD_CACHE_SIZE
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_1000
+#define AP_MISSION_CMD_CACHE_SIZE           128
+#elif HAL_MEM_CLASS >= HAL_MEM_CLASS_500
+#define AP_MISSION_CMD_CACHE_SIZE           32
+#else
+#define AP_MISSION_CMD_CACHE_SIZE           0
+#endif
+#endif
+
 #define AP_MISSION_JUMP_REPEAT_FOREVER      -1      // when do-jump command's repeat count is -1 this means endless repeat
 
 #define AP_MISSION_CMD_ID_NONE              0       // mavlink cmd id of zero means invalid or missing command
@@ -939,6 +952,16 @@ private:
     // const functions
     static HAL_Semaphore _rsem;
 
+#if AP_MISSION_CMD_CACHE_SIZE > 0
+    // direct mapped cache of decoded commands, saves unpacking them
+    // from storage every time the mission is searched. Sized at init
+    // to hold the whole mission if possible. Protected by _rsem, an
+    // entry is empty if its index does not match its slot
+    mutable Mission_Command *_cmd_cache;
+    uint16_t _cmd_cache_size;
+    void init_cmd_cache(void);
+#endif
+
     // mission items common to all vehicles:
     bool start_command_do_aux_function(const AP_Mission::Mission_Command& cmd);
     bool start_command_do_gripper(const AP_Mission::Mission_Command& cmd);
@@ -0,0 +1,127 @@
+#include <AP_gtest.h>
+#include <AP_AHRS/AP_AHRS.h>
+#include <AP_Mission/AP_Mission.h>
+#include <GCS_MAVLink/GCS_Dummy.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+AP_AHRS ahrs{AP_AHRS::FLAG_ALWAYS_USE_EKF};
+
+GCS_Dummy _gcs;
+
+class MissionTest {
+public:
+    bool start_cmd(const AP_Mission::Mission_Command& cmd) { return true; }
+    bool verify_cmd(const AP_Mission::Mission_Command& cmd) { return true; }
+    void mission_complete(void) {}
+
+    AP_Mission mission{
+            FUNCTOR_BIND_MEMBER(&MissionTest::start_cmd, bool, const AP_Mission::Mission_Command &),
+            FUNCTOR_BIND_MEMBER(&MissionTest::verify_cmd, bool, const AP_Mission::Mission_Command &),
+            FUNCTOR_BIND_MEMBER(&MissionTest::mission_complete, void)};
+};
+
+static MissionTest missiontest;
+
+static AP_Mission::Mission_Command waypoint(int32_t lat)
+{
+    AP_Mission::Mission_Command cmd {};
+    cmd.id = MAV_CMD_NAV_WAYPOINT;
+    cmd.content.location.lat = lat;
+    cmd.content.location.lng = -lat;
+    cmd.content.location.alt = 100;
+    return cmd;
+}
+
+// clear the mission and add num waypoints, waypoint i at latitude i
+static void setup_mission(uint16_t num)
+{
+    AP_Mission &mission = missiontest.mission;
+    mission.init();
+    ASSERT_TRUE(mission.clear());
+    for (uint16_t i=1; i<=num; i++) {
+        auto cmd = waypoint(i);
+        ASSERT_TRUE(mission.add_cmd(cmd));
+    }
+    ASSERT_EQ(mission.num_commands(), num+1);
+}
+
+static void expect_waypoint(uint16_t index, int32_t lat)
+{
+    AP_Mission::Mission_Command cmd;
+    ASSERT_TRUE(missiontest.mission.read_cmd_from_storage(index, cmd));
+    EXPECT_EQ(cmd.index, index);
+    EXPECT_EQ(cmd.id, MAV_CMD_NAV_WAYPOINT);
+    EXPECT_EQ(cmd.content.location.lat, lat);
+    EXPECT_EQ(cmd.content.location.lng, -lat);
+}
+
+TEST(MissionCache, WriteThenRead)
+{
+    AP_Mission &mission = missiontest.mission;
+    const uint16_t num = MIN(200, mission.num_commands_max()-1);
+    setup_mission(num);
+
+    // read everything twice so the second pass comes from the cache
+    for (uint8_t pass=0; pass<2; pass++) {
+        for (uint16_t i=1; i<=num; i++) {
+            expect_waypoint(i, i);
+        }
+    }
+
+    // replaced commands are read back, neighbours are unchanged
+    for (uint16_t i=1; i<=num; i+=7) {
+        ASSERT_TRUE(mission.replace_cmd(i, waypoint(1000+i)));
+    }
+    for (uint16_t i=1; i<=num; i++) {
+        expect_waypoint(i, (i-1) % 7 == 0 ? 1000+i : i);
+    }
+
+    // a command of another type replaces a cached waypoint
+    AP_Mission::Mission_Command jump {};
+    jump.id = MAV_CMD_DO_JUMP;
+    jump.content.jump.target = 3;
+    jump.content.jump.num_times = 2;
+    ASSERT_TRUE(mission.replace_cmd(5, jump));
+    AP_Mission::Mission_Command cmd;
+    ASSERT_TRUE(mission.read_cmd_from_storage(5, cmd));
+    EXPECT_EQ(cmd.id, MAV_CMD_DO_JUMP);
+    EXPECT_EQ(cmd.content.jump.target, 3);
+    EXPECT_EQ(cmd.content.jump.num_times, 2);
+}
+
+TEST(MissionCache, TruncateAndClear)
+{
+    AP_Mission &mission = missiontest.mission;
+    const uint16_t num = MIN(100, mission.num_commands_max()-1);
+    setup_mission(num);
+    for (uint16_t i=1; i<=num; i++) {
+        expect_waypoint(i, i);
+    }
+
+    // commands past the end are gone, even though they were cached
+    mission.truncate(10);
+    AP_Mission::Mission_Command cmd;
+    EXPECT_FALSE(mission.read_cmd_from_storage(10, cmd));
+    EXPECT_FALSE(mission.read_cmd_from_storage(num, cmd));
+    expect_waypoint(9, 9);
+
+    // new commands at the old positions are read back, not the old ones
+    for (uint16_t i=10; i<=20; i++) {
+        auto wp = waypoint(2000+i);
+        ASSERT_TRUE(mission.add_cmd(wp));
+        EXPECT_EQ(wp.index, i);
+    }
+    for (uint16_t i=10; i<=20; i++) {
+        expect_waypoint(i, 2000+i);
+    }
+
+    ASSERT_TRUE(mission.clear());
+    EXPECT_FALSE(mission.read_cmd_from_storage(1, cmd));
+    auto wp = waypoint(3000);
+    ASSERT_TRUE(mission.add_cmd(wp));
+    expect_waypoint(1, 3000);
+    EXPECT_FALSE(mission.read_cmd_from_storage(2, cmd));
+}
+
+AP_GTEST_MAIN()
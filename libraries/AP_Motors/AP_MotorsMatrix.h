@@ -121,6 +121,9 @@ protected:
     // remove_motor
     void                remove_motor(int8_t motor_num);
 
+    // rebuild the list of enabled motors used by the mixer
+    void                update_mix_motors();
+
     // configures the motors for the defined frame_class and frame_type
     virtual void        setup_motors(motor_frame_class frame_class, motor_frame_type frame_type);
 
@@ -144,6 +147,8 @@ protected:
     float               _throttle_factor[AP_MOTORS_MAX_NUM_MOTORS];  // each motors contribution to throttle 0~1
     float               _thrust_rpyt_out[AP_MOTORS_MAX_NUM_MOTORS]; // combined roll, pitch, yaw and throttle outputs to motors in 0~1 range
     uint8_t             _test_order[AP_MOTORS_MAX_NUM_MOTORS];  // order of the motors in the test sequence
+    uint8_t             _mix_motor_num[AP_MOTORS_MAX_NUM_MOTORS];   // output number of each enabled motor, in ascending order
+    uint8_t             _mix_num_motors;    // number of enabled motors in _mix_motor_num
 
     // motor failure handling
     float               _thrust_rpyt_out_filt[AP_MOTORS_MAX_NUM_MOTORS];    // filtered thrust outputs with 1 second time constant
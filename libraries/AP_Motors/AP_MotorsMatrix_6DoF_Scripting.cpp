@@ -248,6 +248,7 @@ void AP_MotorsMatrix_6DoF_Scripting::add_motor(int8_t motor_num, float roll_fact
     // ensure valid motor number is provided
     if (motor_num >= 0 && motor_num < AP_MOTORS_MAX_NUM_MOTORS) {
         motor_enabled[motor_num] = true;
+        update_mix_motors();
 
         _roll_factor[motor_num] = roll_factor;
         _pitch_factor[motor_num] = pitch_factor;
@@ -37,6 +37,7 @@ bool AP_MotorsMatrix_Scripting_Dynamic::add_motor(uint8_t motor_num, uint8_t tes
     if (motor_num < AP_MOTORS_MAX_NUM_MOTORS) {
         _test_order[motor_num] = testing_order;
         motor_enabled[motor_num] = true;
+        update_mix_motors();
         return true;
     }
     return false;
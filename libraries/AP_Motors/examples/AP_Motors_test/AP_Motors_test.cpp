@@ -24,6 +24,7 @@ void setup();
 void loop();
 void motor_order_test();
 void stability_test();
+void benchmark_test();
 void update_motors();
 void print_all_motors();
 void print_motor_matrix(uint8_t frame_class, uint8_t frame_type);
@@ -272,6 +273,9 @@ void setup()
         } else if (strcmp(argv[1],"s") == 0) {
             stability_test();
 
+        } else if (strcmp(argv[1],"b") == 0) {
+            benchmark_test();
+
         } else if (strcmp(argv[1],"p") == 0) {
             if (motors_matrix == nullptr) {
                 motors_matrix = new AP_MotorsMatrix(400);
@@ -282,7 +286,7 @@ void setup()
             print_all_motors();
 
         } else {
-            ::printf("Expected first argument: 't', 's' or 'p'\n");
+            ::printf("Expected first argument: 't', 's', 'b' or 'p'\n");
 
         }
 
@@ -582,6 +586,41 @@ void stability_test()
 
 }
 
+// time the mixer over a sweep of inputs
+void benchmark_test()
+{
+    char frame_and_type_string[30];
+    motors->get_frame_and_type_string(frame_and_type_string, ARRAY_SIZE(frame_and_type_string));
+    hal.console->printf("%s\n", frame_and_type_string);
+
+    motors->armed(true);
+    motors->set_interlock(true);
+    motors->set_thrust_boost(thrust_boost);
+    motors->set_desired_spool_state(AP_Motors::DesiredSpoolState::THROTTLE_UNLIMITED);
+
+    // spool up before timing
+    update_motors();
+
+    const uint32_t num_loops = 200000;
+    const uint64_t start_us = AP_HAL::micros64();
+    for (uint32_t i=0; i<num_loops; i++) {
+        // vary inputs so every branch of the mixer is exercised
+        const float phase = (i % 1000) * (M_2PI / 1000);
+        motors->set_roll(sinf(phase));
+        motors->set_pitch(cosf(phase));
+        motors->set_yaw(sinf(2 * phase));
+        motors->set_throttle(0.5 + 0.5 * sinf(3 * phase));
+        motors->output();
+    }
+    const uint64_t dt_us = AP_HAL::micros64() - start_us;
+
+    hal.console->printf("%u loops in %.3f s, %.3f us per loop\n",
+                        (unsigned)num_loops, dt_us * 1.0e-6, double(dt_us) / num_loops);
+
+    motors->set_throttle(0);
+    motors->armed(false);
+}
+
 void update_motors()
 {
     // call update motors 1000 times to get any ramp limiting complete
@@ -185,7 +185,7 @@ void NavEKF3_core::FuseAirspeed()
         }
         // force the covariance matrix to be symmetrical and limit the variances to prevent ill-conditioning.
         ForceSymmetry();
-        ConstrainVariances();
+        ConstrainVariances(false);
     }
 }
 
@@ -463,7 +463,7 @@ void NavEKF3_core::FuseSideslip()
 
     // force the covariance matrix to be symmetrical and limit the variances to prevent ill-conditioning.
     ForceSymmetry();
-    ConstrainVariances();
+    ConstrainVariances(false);
 }
 
 #if EK3_FEATURE_DRAG_FUSION
@@ -883,7 +883,7 @@ void NavEKF3_core::FuseMagnetometer()
 
             // force the covariance matrix to be symmetrical and limit the variances to prevent ill-conditioning.
             ForceSymmetry();
-            ConstrainVariances();
+            ConstrainVariances(false);
 
             // correct the state vector
             for (uint8_t j= 0; j<=stateIndexLim; j++) {
@@ -1231,7 +1231,7 @@ bool NavEKF3_core::fuseEulerYaw(yawFusionMethod method)
 
         // force the covariance matrix to be symmetrical and limit the variances to prevent ill-conditioning.
         ForceSymmetry();
-        ConstrainVariances();
+        ConstrainVariances(false);
 
         // correct the state vector
         for (uint8_t i=0; i<=stateIndexLim; i++) {
@@ -1415,7 +1415,7 @@ void NavEKF3_core::FuseDeclination(ftype declErr)
 
         // force the covariance matrix to be symmetrical and limit the variances to prevent ill-conditioning.
         ForceSymmetry();
-        ConstrainVariances();
+        ConstrainVariances(false);
 
         // correct the state vector
         for (uint8_t j= 0; j<=stateIndexLim; j++) {
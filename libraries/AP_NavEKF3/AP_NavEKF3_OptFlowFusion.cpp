@@ -737,7 +737,7 @@ void NavEKF3_core::FuseOptFlow(const of_elements &ofDataDelayed, bool really_fus
 
                 // force the covariance matrix to be symmetrical and limit the variances to prevent ill-conditioning.
                 ForceSymmetry();
-                ConstrainVariances();
+                ConstrainVariances(false);
 
                 // correct the state vector
                 for (uint8_t j= 0; j<=stateIndexLim; j++) {
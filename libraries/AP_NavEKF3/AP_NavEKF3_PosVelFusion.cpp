@@ -1130,7 +1130,7 @@ void NavEKF3_core::FuseVelPosNED()
 
                     // force the covariance matrix to be symmetrical and limit the variances to prevent ill-conditioning.
                     ForceSymmetry();
-                    ConstrainVariances();
+                    ConstrainVariances(false);
 
                     // update states and renormalise the quaternions
                     for (uint8_t i = 0; i<=stateIndexLim; i++) {
@@ -2042,7 +2042,7 @@ void NavEKF3_core::FuseBodyVel()
 
                 // force the covariance matrix to be symmetrical and limit the variances to prevent ill-conditioning.
                 ForceSymmetry();
-                ConstrainVariances();
+                ConstrainVariances(false);
 
                 // correct the state vector
                 for (uint8_t j= 0; j<=stateIndexLim; j++) {
@@ -300,7 +300,7 @@ void NavEKF3_core::FuseRngBcn()
 
                 // force the covariance matrix to be symmetrical and limit the variances to prevent ill-conditioning.
                 ForceSymmetry();
-                ConstrainVariances();
+                ConstrainVariances(false);
 
                 // correct the state vector
                 for (uint8_t j= 0; j<=stateIndexLim; j++) {
@@ -715,7 +715,8 @@ private:
     void ForceSymmetry();
 
     // constrain variances (diagonal terms) in the state covariance matrix
-    void ConstrainVariances();
+    // inactiveCovZeroed should be true if the covariances of inhibited states inside stateIndexLim are already zero
+    void ConstrainVariances(bool inactiveCovZeroed);
 
     // constrain states
     void ConstrainStates();
@@ -24,6 +24,8 @@
 #include "AP_Param.h"
 
 #include <cmath>
+#include <ctype.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <AP_Common/AP_Common.h>
@@ -104,6 +106,20 @@ uint16_t AP_Param::_count_marker;
 uint16_t AP_Param::_count_marker_done;
 HAL_Semaphore AP_Param::_count_sem;
 
+// cached tokens for find_by_index()
+AP_Param::ParamToken AP_Param::_index_cache[AP_PARAM_INDEX_CACHE_SIZE];
+uint8_t AP_Param::_index_cache_len;
+uint16_t AP_Param::_index_cache_marker;
+HAL_Semaphore AP_Param::_index_cache_sem;
+
+#if AP_PARAM_NAME_INDEX_ENABLED
+// index of parameter names
+struct AP_Param::name_index_entry *AP_Param::_name_index;
+uint16_t AP_Param::_name_index_len;
+uint16_t AP_Param::_name_index_size;
+HAL_Semaphore AP_Param::_name_index_sem;
+#endif
+
 // storage and naming information about all types that can be saved
 const AP_Param::Info *AP_Param::_var_info;
 
@@ -912,65 +928,213 @@ AP_Param::find_group(const char *name, uint16_t vindex, ptrdiff_t group_offset,
 }
 
 
+// Find a variable by name within one top level var_info entry
+//
+AP_Param *
+AP_Param::find_in_var(const char *name, uint16_t vindex, enum ap_var_type *ptype, uint16_t *flags)
+{
+    const auto &info = var_info(vindex);
+    uint8_t type = info.type;
+    if (type == AP_PARAM_GROUP) {
+        uint8_t len = strnlen(info.name, AP_MAX_NAME_SIZE);
+        if (strncmp(name, info.name, len) != 0) {
+            return nullptr;
+        }
+        const struct GroupInfo *group_info = get_group_info(info);
+        if (group_info == nullptr) {
+            return nullptr;
+        }
+        AP_Param *ap = find_group(name + len, vindex, 0, group_info, ptype);
+        if (ap != nullptr && flags != nullptr) {
+            uint32_t group_element = 0;
+            const struct GroupInfo *ginfo;
+            struct GroupNesting group_nesting {};
+            uint8_t idx;
+            ap->find_var_info(&group_element, ginfo, group_nesting, &idx);
+            if (ginfo != nullptr) {
+                *flags = ginfo->flags;
+            }
+        }
+        return ap;
+    }
+    if (strcasecmp(name, info.name) == 0) {
+        *ptype = (enum ap_var_type)type;
+        ptrdiff_t base;
+        if (!get_base(info, base)) {
+            return nullptr;
+        }
+        return (AP_Param *)base;
+    }
+    return nullptr;
+}
+
+#if AP_PARAM_NAME_INDEX_ENABLED
+/*
+  case insensitive FNV-1a hash of a parameter name
+ */
+uint32_t AP_Param::name_hash(const char *name)
+{
+    uint32_t hash = 2166136261U;
+    for (uint8_t i=0; i<AP_MAX_NAME_SIZE && name[i] != 0; i++) {
+        hash ^= (uint8_t)toupper(name[i]);
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+/*
+  (re)build the name index from a walk of all scalar parameters. This
+  is a full walk of the tree so is only done at known points: after
+  load_all() and at the end of vehicle setup once the objects
+  allocated during init have been loaded. Parameters added after that,
+  such as those in script tables, are found by the linear scan
+ */
+void AP_Param::build_name_index(void)
+{
+    WITH_SEMAPHORE(_name_index_sem);
+
+    _name_index_len = 0;
+
+    const uint16_t count = count_parameters();
+    if (count > _name_index_size) {
+        delete[] _name_index;
+        _name_index_size = 0;
+        _name_index = NEW_NOTHROW name_index_entry[count];
+        if (_name_index == nullptr) {
+            return;
+        }
+        _name_index_size = count;
+    }
+
+    ParamToken token {};
+    uint16_t n = 0;
+    for (AP_Param *ap = first(&token, nullptr);
+         ap != nullptr && n < _name_index_size;
+         ap = next_scalar(&token, nullptr)) {
+        char name[AP_MAX_NAME_SIZE+1];
+        ap->copy_name_token(token, name, sizeof(name), true);
+        name[AP_MAX_NAME_SIZE] = 0;
+        _name_index[n].hash = name_hash(name);
+        _name_index[n].vindex = token.key;
+        n++;
+    }
+
+    // sort by hash, keeping var_info order for equal hashes so we
+    // return the same match as a linear scan
+    qsort(_name_index, n, sizeof(_name_index[0]), [](const void *a, const void *b) {
+        const auto &e1 = *(const name_index_entry *)a;
+        const auto &e2 = *(const name_index_entry *)b;
+        if (e1.hash != e2.hash) {
+            return e1.hash < e2.hash ? -1 : 1;
+        }
+        return int(e1.vindex) - int(e2.vindex);
+    });
+    _name_index_len = n;
+}
+
+/*
+  find a variable using the name index. Returns nullptr if the name is
+  not in the index, in which case the caller falls back to a full
+  scan. That covers parameters which were hidden or not yet allocated
+  when the index was built
+ */
+AP_Param *AP_Param::find_indexed(const char *name, enum ap_var_type *ptype, uint16_t *flags)
+{
+    // never block a caller on another thread building the index
+    if (!_name_index_sem.take_nonblocking()) {
+        return nullptr;
+    }
+
+    const uint32_t hash = name_hash(name);
+
+    // binary search for the first entry with this hash
+    uint16_t lo = 0, hi = _name_index_len;
+    while (lo < hi) {
+        const uint16_t mid = (lo + hi) / 2;
+        if (_name_index[mid].hash < hash) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    AP_Param *ap = nullptr;
+    uint16_t last_vindex = UINT16_MAX;
+    for (uint16_t i=lo; i<_name_index_len && _name_index[i].hash == hash && ap == nullptr; i++) {
+        const uint16_t vindex = _name_index[i].vindex;
+        if (vindex == last_vindex || vindex >= _num_vars) {
+            continue;
+        }
+        last_vindex = vindex;
+        ap = find_in_var(name, vindex, ptype, flags);
+    }
+    _name_index_sem.give();
+    return ap;
+}
+#endif // AP_PARAM_NAME_INDEX_ENABLED
+
 // Find a variable by name.
 //
 AP_Param *
 AP_Param::find(const char *name, enum ap_var_type *ptype, uint16_t *flags)
 {
+#if AP_PARAM_NAME_INDEX_ENABLED
+    AP_Param *ap = find_indexed(name, ptype, flags);
+    if (ap != nullptr) {
+        return ap;
+    }
+#endif
     for (uint16_t i=0; i<_num_vars; i++) {
-        const auto &info = var_info(i);
-        uint8_t type = info.type;
-        if (type == AP_PARAM_GROUP) {
-            uint8_t len = strnlen(info.name, AP_MAX_NAME_SIZE);
-            if (strncmp(name, info.name, len) != 0) {
-                continue;
-            }
-            const struct GroupInfo *group_info = get_group_info(info);
-            if (group_info == nullptr) {
-                continue;
-            }
-            AP_Param *ap = find_group(name + len, i, 0, group_info, ptype);
-            if (ap != nullptr) {
-                if (flags != nullptr) {
-                    uint32_t group_element = 0;
-                    const struct GroupInfo *ginfo;
-                    struct GroupNesting group_nesting {};
-                    uint8_t idx;
-                    ap->find_var_info(&group_element, ginfo, group_nesting, &idx);
-                    if (ginfo != nullptr) {
-                        *flags = ginfo->flags;
-                    }
-                }
-                return ap;
-            }
-            // we continue looking as we want to allow top level
-            // parameter to have the same prefix name as group
-            // parameters, for example CAM_P_G
-        } else if (strcasecmp(name, info.name) == 0) {
-            *ptype = (enum ap_var_type)type;
-            ptrdiff_t base;
-            if (!get_base(info, base)) {
-                return nullptr;
-            }
-            return (AP_Param *)base;
+        // we continue looking after a group match fails as we want
+        // to allow top level parameter to have the same prefix name
+        // as group parameters, for example CAM_P_G
+        AP_Param *vp = find_in_var(name, i, ptype, flags);
+        if (vp != nullptr) {
+            return vp;
         }
     }
     return nullptr;
 }
 
-// Find a variable by index. Note that this is quite slow.
+// Find a variable by index. This walks the tree from the nearest
+// cached token, so a GCS filling in gaps after a lossy parameter
+// download does not restart the walk from the first parameter for
+// every request
 //
 AP_Param *
 AP_Param::find_by_index(uint16_t idx, enum ap_var_type *ptype, ParamToken *token)
 {
+    WITH_SEMAPHORE(_index_cache_sem);
+
+    if (_index_cache_marker != _count_marker) {
+        // the tree has changed, so the cached tokens may be stale
+        _index_cache_len = 0;
+        _index_cache_marker = _count_marker;
+    }
+
     AP_Param *ap;
-    uint16_t count=0;
-    for (ap=AP_Param::first(token, ptype);
-         ap && count < idx;
-         ap=AP_Param::next_scalar(token, ptype)) {
+    uint16_t count = 0;
+    const uint16_t n = MIN(idx / AP_PARAM_INDEX_CACHE_STEP, _index_cache_len);
+    if (n == 0) {
+        ap = AP_Param::first(token, ptype);
+    } else {
+        *token = _index_cache[n-1];
+        ap = AP_Param::next_scalar(token, ptype);
+        count = n * AP_PARAM_INDEX_CACHE_STEP;
+    }
+
+    while (ap && count < idx) {
+        if ((count+1) % AP_PARAM_INDEX_CACHE_STEP == 0) {
+            const uint16_t i = (count+1) / AP_PARAM_INDEX_CACHE_STEP - 1;
+            if (i == _index_cache_len && i < ARRAY_SIZE(_index_cache)) {
+                _index_cache[i] = *token;
+                _index_cache_len++;
+            }
+        }
+        ap = AP_Param::next_scalar(token, ptype);
         count++;
     }
-    return ap;    
+    return ap;
 }
 
 // by-name equivalent of find_by_index()
@@ -1315,6 +1479,8 @@ void AP_Param::flush(void)
         hal.scheduler->delay(10);
         hal.scheduler->expect_delay_ms(0);
     }
+    // make sure the HAL isn't holding the saved values back
+    hal.storage->flush();
 }
 
 // Load the variable from EEPROM, if supported
@@ -1585,6 +1751,9 @@ bool AP_Param::load_all()
         if (is_sentinal(phdr)) {
             // we've reached the sentinal
             sentinal_offset = ofs;
+#if AP_PARAM_NAME_INDEX_ENABLED
+            build_name_index();
+#endif
             return true;
         }
 
@@ -1601,6 +1770,9 @@ bool AP_Param::load_all()
 
     // we didn't find the sentinal
     Debug("no sentinal in load_all");
+#if AP_PARAM_NAME_INDEX_ENABLED
+    build_name_index();
+#endif
     return false;
 }
 
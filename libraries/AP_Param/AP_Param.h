@@ -66,6 +66,15 @@
 #define AP_PARAM_DYNAMIC_ENABLED AP_SCRIPTING_ENABLED
 #endif
 
+// number of tokens cached for find_by_index() and the number of
+// parameters between them
+#ifndef AP_PARAM_INDEX_CACHE_SIZE
+#define AP_PARAM_INDEX_CACHE_SIZE 64
+#endif
+#ifndef AP_PARAM_INDEX_CACHE_STEP
+#define AP_PARAM_INDEX_CACHE_STEP 32
+#endif
+
 // maximum number of dynamically created tables (from scripts)
 #ifndef AP_PARAM_MAX_DYNAMIC
 #define AP_PARAM_MAX_DYNAMIC 10
@@ -579,6 +588,12 @@ public:
     // invalidate parameter count
     static void invalidate_count(void);
 
+#if AP_PARAM_NAME_INDEX_ENABLED
+    // rebuild the index used by find(). Walks the whole tree, so call
+    // only once the set of parameters has settled
+    static void build_name_index(void);
+#endif
+
     static void set_hide_disabled_groups(bool value) { _hide_disabled_groups = value; }
 
     // set frame type flags. Used to unhide frame specific parameters
@@ -744,6 +759,18 @@ private:
                                     ptrdiff_t group_offset,
                                     const struct GroupInfo *group_info,
                                     enum ap_var_type *ptype);
+    static AP_Param *           find_in_var(
+                                    const char *name,
+                                    uint16_t vindex,
+                                    enum ap_var_type *ptype,
+                                    uint16_t *flags);
+#if AP_PARAM_NAME_INDEX_ENABLED
+    static uint32_t             name_hash(const char *name);
+    static AP_Param *           find_indexed(
+                                    const char *name,
+                                    enum ap_var_type *ptype,
+                                    uint16_t *flags);
+#endif
     static void                 write_sentinal(uint16_t ofs);
     static uint16_t             get_key(const Param_header &phdr);
     static void                 set_key(Param_header &phdr, uint16_t key);
@@ -817,8 +844,36 @@ private:
     static uint16_t             _count_marker;
     static uint16_t             _count_marker_done;
     static HAL_Semaphore        _count_sem;
+
+    /*
+      tokens saved every AP_PARAM_INDEX_CACHE_STEP parameters along
+      the walk done by find_by_index(), so random access by index only
+      walks from the nearest saved token. Entry i holds the token for
+      index (i+1)*AP_PARAM_INDEX_CACHE_STEP-1
+     */
+    static ParamToken           _index_cache[AP_PARAM_INDEX_CACHE_SIZE];
+    static uint8_t              _index_cache_len;
+    static uint16_t             _index_cache_marker;
+    static HAL_Semaphore        _index_cache_sem;
     static const struct Info *  _var_info;
 
+#if AP_PARAM_NAME_INDEX_ENABLED
+    /*
+      index of the hash of each scalar parameter name to the top level
+      var_info entry it lives in, sorted by hash. Used to avoid a
+      linear scan of the whole tree in find(). Built by
+      build_name_index()
+     */
+    struct name_index_entry {
+        uint32_t hash;
+        uint16_t vindex;
+    };
+    static struct name_index_entry *_name_index;
+    static uint16_t             _name_index_len;
+    static uint16_t             _name_index_size;
+    static HAL_Semaphore        _name_index_sem;
+#endif
+
 #if AP_PARAM_DYNAMIC_ENABLED
     // allow for a dynamically allocated var table
     static uint16_t             _num_vars_base;
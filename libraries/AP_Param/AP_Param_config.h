@@ -11,3 +11,11 @@
 #ifndef FORCE_APJ_DEFAULT_PARAMETERS
 #define FORCE_APJ_DEFAULT_PARAMETERS 0
 #endif
+
+/*
+  index of parameter names to speed up AP_Param::find(). Costs 8 bytes
+  of RAM per parameter
+ */
+#ifndef AP_PARAM_NAME_INDEX_ENABLED
+#define AP_PARAM_NAME_INDEX_ENABLED (HAL_MEM_CLASS >= HAL_MEM_CLASS_1000)
+#endif
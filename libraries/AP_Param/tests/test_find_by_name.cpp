@@ -7,16 +7,40 @@
 
 const AP_HAL::HAL& hal = AP_HAL::get_HAL();
 
+// a group with more than 2*AP_PARAM_INDEX_CACHE_STEP scalars so
+// find_by_index() walks from cached tokens
+class Many {
+public:
+    static const struct AP_Param::GroupInfo var_info[];
+    AP_Vector3f v[24];
+};
+
+#define MANY_VEC(n) AP_GROUPINFO("V" #n, n, Many, v[n], 0)
+
+const AP_Param::GroupInfo Many::var_info[] {
+    MANY_VEC(0),  MANY_VEC(1),  MANY_VEC(2),  MANY_VEC(3),
+    MANY_VEC(4),  MANY_VEC(5),  MANY_VEC(6),  MANY_VEC(7),
+    MANY_VEC(8),  MANY_VEC(9),  MANY_VEC(10), MANY_VEC(11),
+    MANY_VEC(12), MANY_VEC(13), MANY_VEC(14), MANY_VEC(15),
+    MANY_VEC(16), MANY_VEC(17), MANY_VEC(18), MANY_VEC(19),
+    MANY_VEC(20), MANY_VEC(21), MANY_VEC(22), MANY_VEC(23),
+    AP_GROUPEND
+};
+
+static_assert(ARRAY_SIZE(Many::var_info) * 3 > 2 * AP_PARAM_INDEX_CACHE_STEP, "too few params to use the index cache");
+
 class Parameters {
 public:
     enum {
         k_param_a,
         k_param_b,
         k_param_c,
+        k_param_many,
     };
     AP_Int8 a;
     AP_Int8 b;
     AP_Int8 c;
+    Many many;
 };
 
 class TestVehicle : public AP_Vehicle {
@@ -73,11 +97,16 @@ const AP_Param::Info TestVehicle::var_info[] {
     GSCALAR(b,         "AA", 0),
     GSCALAR(b,         "CC", 0),
     GSCALAR(b,         "BB", 0),
+    GGROUP(many,       "M_", Many),
+    AP_VAREND
 };
 
 TEST(FindByName, Bob)
 {
     for (const auto &x : TestVehicle::var_info) {
+        if (x.type == AP_PARAM_GROUP || x.type == AP_PARAM_NONE) {
+            continue;
+        }
         enum ap_var_type ptype = (ap_var_type)-1;
         AP_Param::ParamToken token = AP_Param::ParamToken {};
         AP_Param *p = AP_Param::find_by_name(x.name, &ptype, &token);
@@ -85,4 +114,74 @@ TEST(FindByName, Bob)
     }
 }
 
+static void check_find(void)
+{
+    for (const auto &x : TestVehicle::var_info) {
+        if (x.type == AP_PARAM_GROUP || x.type == AP_PARAM_NONE) {
+            continue;
+        }
+        enum ap_var_type ptype = (ap_var_type)-1;
+        AP_Param *p = AP_Param::find(x.name, &ptype);
+        EXPECT_EQ(p, (AP_Param *)x.ptr);
+        EXPECT_EQ(ptype, AP_PARAM_INT8);
+    }
+
+    // names are case insensitive
+    enum ap_var_type ptype;
+    EXPECT_EQ(AP_Param::find("aa", &ptype), (AP_Param *)&testvehicle.g.b);
+
+    EXPECT_EQ(AP_Param::find("D", &ptype), nullptr);
+    EXPECT_EQ(AP_Param::find("AAA", &ptype), nullptr);
+
+    // group members, including vector elements
+    EXPECT_EQ(AP_Param::find("M_V17", &ptype), (AP_Param *)&testvehicle.g.many.v[17]);
+    EXPECT_EQ(ptype, AP_PARAM_VECTOR3F);
+    EXPECT_EQ(AP_Param::find("M_V23_Z", &ptype), (AP_Param *)&testvehicle.g.many.v[23].get().z);
+    EXPECT_EQ(ptype, AP_PARAM_FLOAT);
+}
+
+TEST(Find, ByName)
+{
+    check_find();
+#if AP_PARAM_NAME_INDEX_ENABLED
+    // same results through the name index
+    AP_Param::build_name_index();
+    check_find();
+#endif
+}
+
+TEST(FindByIndex, MatchesWalk)
+{
+    AP_Param::ParamToken token {};
+    enum ap_var_type ptype;
+    uint16_t count = 0;
+    for (AP_Param *ap = AP_Param::first(&token, &ptype);
+         ap != nullptr;
+         ap = AP_Param::next_scalar(&token, &ptype)) {
+        AP_Param::ParamToken token2 {};
+        enum ap_var_type ptype2;
+        EXPECT_EQ(AP_Param::find_by_index(count, &ptype2, &token2), ap);
+        EXPECT_EQ(ptype2, ptype);
+        EXPECT_EQ(token2.key, token.key);
+        count++;
+    }
+    EXPECT_GT(count, 2 * AP_PARAM_INDEX_CACHE_STEP);
+    AP_Param::ParamToken token2 {};
+    EXPECT_EQ(AP_Param::find_by_index(count, &ptype, &token2), nullptr);
+
+    // random access, going backwards across cached tokens
+    for (uint16_t i=count; i>0; i--) {
+        const uint16_t idx = (i * 37U) % count;
+        AP_Param::ParamToken t1 {};
+        AP_Param::ParamToken t2 {};
+        enum ap_var_type ptype1, ptype2;
+        AP_Param *ap = AP_Param::first(&t1, &ptype1);
+        for (uint16_t j=0; j<idx; j++) {
+            ap = AP_Param::next_scalar(&t1, &ptype1);
+        }
+        EXPECT_EQ(AP_Param::find_by_index(idx, &ptype2, &t2), ap);
+        EXPECT_EQ(ptype2, ptype1);
+    }
+}
+
 AP_GTEST_MAIN()
@@ -139,14 +139,17 @@ public:
     bool get_horizontal_distances(Proximity_Distance_Array &prx_dist_array) const;
 
     // get total number of obstacles, used in GPS based Simple Avoidance
-    uint8_t get_obstacle_count() const;
+    uint16_t get_obstacle_count() const;
+
+    // get the first obstacle_num at or after start that may be valid, or get_obstacle_count() if none
+    uint16_t get_next_obstacle(uint16_t start) const;
 
     // get vector to obstacle based on obstacle_num passed, used in GPS based Simple Avoidance
-    bool get_obstacle(uint8_t obstacle_num, Vector3f& vec_to_obstacle) const;
+    bool get_obstacle(uint16_t obstacle_num, Vector3f& vec_to_obstacle) const;
 
     // returns shortest distance to "obstacle_num" obstacle, from a line segment formed between "seg_start" and "seg_end"
     // returns FLT_MAX if it's an invalid instance.
-    bool closest_point_from_segment_to_obstacle(uint8_t obstacle_num, const Vector3f& seg_start, const Vector3f& seg_end, Vector3f& closest_point) const;
+    bool closest_point_from_segment_to_obstacle(uint16_t obstacle_num, const Vector3f& seg_start, const Vector3f& seg_end, Vector3f& closest_point) const;
 
     // get distance and angle to closest object (used for pre-arm check)
     //   returns true on success, false if no valid readings
@@ -157,7 +160,7 @@ public:
     bool get_object_angle_and_distance(uint8_t object_number, float& angle_deg, float &distance) const;
 
     // get obstacle pitch and angle for a particular obstacle num
-    bool get_obstacle_info(uint8_t obstacle_num, float &angle_deg, float &pitch, float &distance) const;
+    bool get_obstacle_info(uint16_t obstacle_num, float &angle_deg, float &pitch, float &distance) const;
 
     //
     // mavlink related methods
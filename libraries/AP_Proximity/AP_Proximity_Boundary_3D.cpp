@@ -28,13 +28,12 @@ AP_Proximity_Boundary_3D::AP_Proximity_Boundary_3D()
 }
 
 // initialise the boundary and sector_edge_vector array used for object avoidance
-//   should be called if the sector_middle_deg or _sector_width_deg arrays are changed
 void AP_Proximity_Boundary_3D::init()
 {
     for (uint8_t layer=0; layer < PROXIMITY_NUM_LAYERS; layer++) {
-        const float pitch = ((float)_pitch_middle_deg[layer]);
+        const float pitch = pitch_middle_deg(layer);
         for (uint8_t sector=0; sector < PROXIMITY_NUM_SECTORS; sector++) {
-            const float angle_rad = ((float)_sector_middle_deg[sector]+(PROXIMITY_SECTOR_WIDTH_DEG/2.0f));
+            const float angle_rad = sector_middle_deg(sector)+(PROXIMITY_SECTOR_WIDTH_DEG/2.0f);
             _sector_edge_vector[layer][sector].offset_bearing(angle_rad, pitch, 100.0f);
             _boundary_points[layer][sector] = _sector_edge_vector[layer][sector] * PROXIMITY_BOUNDARY_DIST_DEFAULT;
         }
@@ -46,9 +45,10 @@ void AP_Proximity_Boundary_3D::init()
 // yaw is the horizontal body-frame angle (in degrees) to the obstacle (0=directly ahead of the vehicle, 90 is to the right of the vehicle)
 AP_Proximity_Boundary_3D::Face AP_Proximity_Boundary_3D::get_face(float pitch, float yaw) const
 {
-    const uint8_t sector = wrap_360(yaw + (PROXIMITY_SECTOR_WIDTH_DEG * 0.5f)) / 45.0f;
-    const float pitch_limited = constrain_float(pitch, -75.0f, 74.9f);
-    const uint8_t layer = (pitch_limited + 75.0f)/PROXIMITY_PITCH_WIDTH_DEG;
+    // limit sector in case of rounding when yaw is just below 360
+    const uint8_t sector = MIN(uint8_t(wrap_360(yaw + (PROXIMITY_SECTOR_WIDTH_DEG * 0.5f)) / PROXIMITY_SECTOR_WIDTH_DEG), PROXIMITY_NUM_SECTORS - 1);
+    const float pitch_limited = constrain_float(pitch, -PROXIMITY_PITCH_MAX_DEG, PROXIMITY_PITCH_MAX_DEG - 0.1f);
+    const uint8_t layer = (pitch_limited + PROXIMITY_PITCH_MAX_DEG)/PROXIMITY_PITCH_WIDTH_DEG;
     return Face{layer, sector};
 }
 
@@ -75,7 +75,7 @@ void AP_Proximity_Boundary_3D::set_face_attributes(const Face &face, float pitch
     _angle[face.layer][face.sector] = angle;
     _pitch[face.layer][face.sector] = pitch;
     _distance[face.layer][face.sector] = distance;
-    _distance_valid[face.layer][face.sector] = true;
+    set_distance_valid(face.layer, face.sector, true);
     _prx_instance[face.layer][face.sector] = prx_instance;
 
     // apply filter
@@ -179,6 +179,26 @@ void AP_Proximity_Boundary_3D::reset()
             _distance_valid[layer][sector] = false;
         }
     }
+    _obstacle_mask.clearall();
+}
+
+// mark a face's distance as valid or invalid. An obstacle_num is valid
+// if its own face or one of the next two faces cw hold a distance, see
+// convert_obstacle_num_to_face, so the two faces ccw are updated too
+void AP_Proximity_Boundary_3D::set_distance_valid(uint8_t layer, uint8_t sector, bool valid)
+{
+    _distance_valid[layer][sector] = valid;
+
+    uint8_t obstacle_sector = sector;
+    for (uint8_t i=0; i < 3; i++) {
+        const uint8_t next1 = get_next_sector(obstacle_sector);
+        const uint8_t next2 = get_next_sector(next1);
+        _obstacle_mask.setonoff(layer * PROXIMITY_NUM_SECTORS + obstacle_sector,
+                                _distance_valid[layer][obstacle_sector] ||
+                                _distance_valid[layer][next1] ||
+                                _distance_valid[layer][next2]);
+        obstacle_sector = get_prev_sector(obstacle_sector);
+    }
 }
 
 // Reset this location, specified by Face object, back to default
@@ -203,7 +223,7 @@ void AP_Proximity_Boundary_3D::reset_face(const Face &face, uint8_t prx_instance
         }
     }
 
-    _distance_valid[face.layer][face.sector] = false;
+    set_distance_valid(face.layer, face.sector, false);
 
     // update simple avoidance boundary
     update_boundary(face);
@@ -224,7 +244,7 @@ void AP_Proximity_Boundary_3D::check_face_timeout()
             if (_distance_valid[layer][sector]) {
                 if ((now_ms - _last_update_ms[layer][sector]) > PROXIMITY_FACE_RESET_MS) {
                     // this face has a valid distance but wasn't updated for a long time, reset it
-                    _distance_valid[layer][sector] = false;
+                    set_distance_valid(layer, sector, false);
                     update_boundary(AP_Proximity_Boundary_3D::Face{layer, sector});
                 }
             }
@@ -247,17 +267,28 @@ bool AP_Proximity_Boundary_3D::get_distance(const Face &face, float &distance) c
 }
 
 // get the total number of obstacles 
-uint8_t AP_Proximity_Boundary_3D::get_obstacle_count() const
+uint16_t AP_Proximity_Boundary_3D::get_obstacle_count() const
 {
     return PROXIMITY_NUM_LAYERS * PROXIMITY_NUM_SECTORS;
 }
 
+// get the first obstacle_num at or after start which may produce a
+// valid obstacle, or get_obstacle_count() if there are none
+uint16_t AP_Proximity_Boundary_3D::get_next_obstacle(uint16_t start) const
+{
+    const int16_t next = _obstacle_mask.next_set(start);
+    if (next < 0) {
+        return get_obstacle_count();
+    }
+    return next;
+}
+
 // Converts obstacle_num passed from avoidance library into appropriate face of the boundary
 // Returns false if the face is invalid
 // "update_boundary" method manipulates two sectors ccw and one sector cw from any valid face.
 // Any boundary that does not fall into these manipulated faces are useless, and will be marked as false
 // The resultant is packed into a Boundary Location object and returned by reference as "face"
-bool AP_Proximity_Boundary_3D::convert_obstacle_num_to_face(uint8_t obstacle_num, Face& face) const
+bool AP_Proximity_Boundary_3D::convert_obstacle_num_to_face(uint16_t obstacle_num, Face& face) const
 {
     // obstacle num is just "flattened layers, and sectors"
     const uint8_t layer = obstacle_num / PROXIMITY_NUM_SECTORS;
@@ -284,7 +315,7 @@ bool AP_Proximity_Boundary_3D::convert_obstacle_num_to_face(uint8_t obstacle_num
 // Then returns the closest point on this line from vehicle, in body-frame. 
 // Used by GPS based Simple Avoidance  
 // False is returned if the obstacle_num provided does not produce a valid obstacle 
-bool AP_Proximity_Boundary_3D::get_obstacle(uint8_t obstacle_num, Vector3f& vec_to_obstacle) const
+bool AP_Proximity_Boundary_3D::get_obstacle(uint16_t obstacle_num, Vector3f& vec_to_obstacle) const
 {
     Face face;
     if (!convert_obstacle_num_to_face(obstacle_num, face)) {
@@ -308,7 +339,7 @@ bool AP_Proximity_Boundary_3D::get_obstacle(uint8_t obstacle_num, Vector3f& vec_
 // This helps us know if the passed line segment was in the direction of the boundary, or going in a different direction.
 // Used by GPS based Simple Avoidance  - for "brake mode"
 // False is returned if the obstacle_num provided does not produce a valid obstacle
-bool AP_Proximity_Boundary_3D::closest_point_from_segment_to_obstacle(uint8_t obstacle_num, const Vector3f& seg_start, const Vector3f& seg_end, Vector3f& closest_point) const
+bool AP_Proximity_Boundary_3D::closest_point_from_segment_to_obstacle(uint16_t obstacle_num, const Vector3f& seg_start, const Vector3f& seg_end, Vector3f& closest_point) const
 {
     Face face;
     if (!convert_obstacle_num_to_face(obstacle_num, face)) {
@@ -381,12 +412,12 @@ bool AP_Proximity_Boundary_3D::get_horizontal_object_angle_and_distance(uint8_t
 
 // get an obstacle info for AP_Periph
 // returns false if no angle or distance could be returned for some reason
-bool AP_Proximity_Boundary_3D::get_obstacle_info(uint8_t obstacle_num, float &angle_deg, float &pitch_deg, float &distance) const
+bool AP_Proximity_Boundary_3D::get_obstacle_info(uint16_t obstacle_num, float &angle_deg, float &pitch_deg, float &distance) const
 {
     // obstacle num is just "flattened layers, and sectors"
     const uint8_t layer = obstacle_num / PROXIMITY_NUM_SECTORS;
     const uint8_t sector = obstacle_num % PROXIMITY_NUM_SECTORS;
-    if (_distance_valid[layer][sector]) {
+    if ((layer < PROXIMITY_NUM_LAYERS) && _distance_valid[layer][sector]) {
         angle_deg = _angle[layer][sector];
         pitch_deg = _pitch[layer][sector];
         distance = _filtered_distance[layer][sector].get();
@@ -413,20 +444,39 @@ bool AP_Proximity_Boundary_3D::get_filtered_distance(const Face &face, float &di
 }
 
 // Get raw and filtered distances in 8 directions per layer
+// if there are more than 8 sectors the shortest distance within 22.5 degrees of each direction is used
 bool AP_Proximity_Boundary_3D::get_layer_distances(uint8_t layer_number, float dist_max, Proximity_Distance_Array &prx_dist_array, Proximity_Distance_Array &prx_filt_dist_array) const
 {
+    if (layer_number >= PROXIMITY_NUM_LAYERS) {
+        return false;
+    }
+
     // cycle through all sectors filling in distances and orientations
     // see MAV_SENSOR_ORIENTATION for orientations (0 = forward, 1 = 45 degree clockwise from north, etc)
+    const uint8_t sectors_per_direction = PROXIMITY_NUM_SECTORS / PROXIMITY_MAX_DIRECTION;
     bool valid_distances = false;
     prx_dist_array.offset_valid = 0;
     prx_filt_dist_array.offset_valid = 0;
     for (uint8_t i=0; i<PROXIMITY_MAX_DIRECTION; i++) {
         prx_dist_array.orientation[i] = i;
-        const AP_Proximity_Boundary_3D::Face face(layer_number, i);
-        if (!face.valid()) {
-            return false;
+        bool direction_valid = false;
+        // first sector is half a direction counter-clockwise from the direction's middle
+        uint8_t sector = (i * sectors_per_direction + PROXIMITY_NUM_SECTORS - sectors_per_direction / 2) % PROXIMITY_NUM_SECTORS;
+        for (uint8_t j=0; j<sectors_per_direction; j++) {
+            const AP_Proximity_Boundary_3D::Face face(layer_number, sector);
+            float distance, filt_distance;
+            if (get_distance(face, distance) && get_filtered_distance(face, filt_distance)) {
+                if (!direction_valid || (distance < prx_dist_array.distance[i])) {
+                    prx_dist_array.distance[i] = distance;
+                }
+                if (!direction_valid || (filt_distance < prx_filt_dist_array.distance[i])) {
+                    prx_filt_dist_array.distance[i] = filt_distance;
+                }
+                direction_valid = true;
+            }
+            sector = get_next_sector(sector);
         }
-        if (get_distance(face, prx_dist_array.distance[i]) && get_filtered_distance(face, prx_filt_dist_array.distance[i])) {
+        if (direction_valid) {
             valid_distances = true;
             prx_dist_array.offset_valid |= (1U << i);
             prx_filt_dist_array.offset_valid |= (1U << i);
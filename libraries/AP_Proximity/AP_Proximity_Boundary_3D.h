@@ -16,13 +16,20 @@
 #pragma once
 
 #include <AP_Common/AP_Common.h>
+#include <AP_Common/Bitmask.h>
 #include <AP_Math/AP_Math.h>
 #include <Filter/LowPassFilter.h>
 
+// boundary resolution may be increased at build time for 360 degree lidars, e.g. 72 sectors (5 deg) and 9 layers
+#ifndef PROXIMITY_NUM_SECTORS
 #define PROXIMITY_NUM_SECTORS         8       // number of sectors
+#endif
+#ifndef PROXIMITY_NUM_LAYERS
 #define PROXIMITY_NUM_LAYERS          5       // num of layers in a sector
-#define PROXIMITY_MIDDLE_LAYER        2       // middle layer
-#define PROXIMITY_PITCH_WIDTH_DEG     30      // width between each layer in degrees
+#endif
+#define PROXIMITY_MIDDLE_LAYER        (PROXIMITY_NUM_LAYERS/2)          // middle layer
+#define PROXIMITY_PITCH_MAX_DEG       75.0f   // layers cover pitch angles from -75 to +75 degrees
+#define PROXIMITY_PITCH_WIDTH_DEG     (2.0f*PROXIMITY_PITCH_MAX_DEG/PROXIMITY_NUM_LAYERS)   // width between each layer in degrees
 #define PROXIMITY_SECTOR_WIDTH_DEG    (360.0f/PROXIMITY_NUM_SECTORS)   // width of sectors in degrees
 #define PROXIMITY_BOUNDARY_DIST_MIN   0.6f    // minimum distance for a boundary point.  This ensures the object avoidance code doesn't think we are outside the boundary.
 #define PROXIMITY_BOUNDARY_DIST_DEFAULT 100   // if we have no data for a sector, boundary is placed 100m out
@@ -65,8 +72,8 @@ public:
 	    bool operator ==(const Face &other) const { return ((layer == other.layer) && (sector == other.sector)); }
 	    bool operator !=(const Face &other) const { return ((layer != other.layer) || (sector != other.sector)); }
 
-        uint8_t layer;  // vertical "steps" on the 3D Boundary. 0th layer is the bottom most layer, 1st layer is 30 degrees above (in body frame) and so on
-        uint8_t sector; // horizontal "steps" on the 3D Boundary. 0th sector is directly in front of the vehicle. Each sector is 45 degrees wide.
+        uint8_t layer;  // vertical "steps" on the 3D Boundary. 0th layer is the bottom most layer, 1st layer is PROXIMITY_PITCH_WIDTH_DEG (30 by default) degrees above (in body frame) and so on
+        uint8_t sector; // horizontal "steps" on the 3D Boundary. 0th sector is directly in front of the vehicle. Each sector is PROXIMITY_SECTOR_WIDTH_DEG (45 by default) degrees wide.
     };
 
     // returns face corresponding to the provided yaw and (optionally) pitch
@@ -103,15 +110,20 @@ public:
     bool get_distance(const Face &face, float &distance) const;
 
     // Get the total number of obstacles
-    uint8_t get_obstacle_count() const;
+    uint16_t get_obstacle_count() const;
+
+    // Get the first obstacle_num at or after start which may produce a
+    // valid obstacle, or get_obstacle_count() if there are none. This
+    // lets callers skip the faces without a valid distance
+    uint16_t get_next_obstacle(uint16_t start) const;
 
     // Returns a body frame vector (in cm) to an obstacle
     // False is returned if the obstacle_num provided does not produce a valid obstacle
-    bool get_obstacle(uint8_t obstacle_num, Vector3f& vec_to_boundary) const;
+    bool get_obstacle(uint16_t obstacle_num, Vector3f& vec_to_boundary) const;
 
     // Returns a body frame vector (in cm) nearest to obstacle, in betwen seg_start and seg_end
     // True is returned if the segment intersects a plane formed by considering the "closest point" as normal vector to the plane.
-    bool closest_point_from_segment_to_obstacle(uint8_t obstacle_num, const Vector3f& seg_start, const Vector3f& seg_end, Vector3f& closest_point) const;
+    bool closest_point_from_segment_to_obstacle(uint16_t obstacle_num, const Vector3f& seg_start, const Vector3f& seg_end, Vector3f& closest_point) const;
 
     // get distance and angle to closest object (used for pre-arm check)
     //   returns true on success, false if no valid readings
@@ -122,23 +134,27 @@ public:
     bool get_horizontal_object_angle_and_distance(uint8_t object_number, float& angle_deg, float &distance) const;
 
     // get obstacle info for AP_Periph
-    bool get_obstacle_info(uint8_t obstacle_num, float &angle_deg, float &pitch_deg, float &distance) const;
+    bool get_obstacle_info(uint16_t obstacle_num, float &angle_deg, float &pitch_deg, float &distance) const;
 
     // get number of layers
     uint8_t get_num_layers() const { return PROXIMITY_NUM_LAYERS; }
 
     // get raw and filtered distances in 8 directions per layer.
+    // if there are more than 8 sectors the shortest distance within 22.5 degrees of each direction is used
     bool get_layer_distances(uint8_t layer_number, float dist_max, Proximity_Distance_Array &prx_dist_array, Proximity_Distance_Array &prx_filt_dist_array) const;
 
     // pass down filter cut-off freq from params
     void set_filter_freq(float filt_freq) { _filter_freq = filt_freq; }
 
-    // sectors
-    static_assert(PROXIMITY_NUM_SECTORS == 8, "PROXIMITY_NUM_SECTOR must be 8");
-    const uint16_t _sector_middle_deg[PROXIMITY_NUM_SECTORS] {0, 45, 90, 135, 180, 225, 270, 315};    // middle angle of each sector
-    // layers
-    static_assert(PROXIMITY_NUM_LAYERS == 5, "PROXIMITY_NUM_LAYERS must be 5");
-    const int16_t _pitch_middle_deg[PROXIMITY_NUM_LAYERS] {-60, -30, 0, 30, 60};
+    // sectors must map evenly onto the 8 directions sent to the GCS and be addressable by Face
+    static_assert((PROXIMITY_NUM_SECTORS >= PROXIMITY_MAX_DIRECTION) && (PROXIMITY_NUM_SECTORS % PROXIMITY_MAX_DIRECTION == 0) && (PROXIMITY_NUM_SECTORS <= 120), "PROXIMITY_NUM_SECTORS must be a multiple of 8 between 8 and 120");
+    // an odd number of layers places the middle layer at zero pitch
+    static_assert((PROXIMITY_NUM_LAYERS % 2 == 1) && (PROXIMITY_NUM_LAYERS <= 15), "PROXIMITY_NUM_LAYERS must be odd and no more than 15");
+
+    // middle angle of a sector in degrees
+    static float sector_middle_deg(uint8_t sector) { return sector * PROXIMITY_SECTOR_WIDTH_DEG; }
+    // middle pitch of a layer in degrees
+    static float pitch_middle_deg(uint8_t layer) { return ((int16_t)layer - PROXIMITY_MIDDLE_LAYER) * PROXIMITY_PITCH_WIDTH_DEG; }
 
 private:
 
@@ -156,7 +172,10 @@ private:
     // "update_boundary" method manipulates two sectors ccw and one sector cw from any valid face.
     // Any boundary that does not fall into these manipulated faces are useless, and will be marked as false
     // The resultant is packed into a Boundary Location object and returned by reference as "face"
-    bool convert_obstacle_num_to_face(uint8_t obstacle_num, Face& face) const WARN_IF_UNUSED;
+    bool convert_obstacle_num_to_face(uint16_t obstacle_num, Face& face) const WARN_IF_UNUSED;
+
+    // mark a face's distance as valid or invalid, keeping _obstacle_mask up to date
+    void set_distance_valid(uint8_t layer, uint8_t sector, bool valid);
 
     // Apply a new cutoff_freq to low-pass filter
     void apply_filter_freq(float cutoff_freq);
@@ -174,6 +193,7 @@ private:
     float _pitch[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS];          // pitch angle in degrees to the closest object within each sector and layer
     float _distance[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS];       // distance to closest object within each sector and layer
     bool _distance_valid[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS];  // true if a valid distance received for each sector and layer
+    Bitmask<PROXIMITY_NUM_LAYERS*PROXIMITY_NUM_SECTORS> _obstacle_mask; // obstacle_nums which convert to a valid face
     uint32_t _last_update_ms[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS]; // time when distance was last updated
     uint8_t _prx_instance[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS]; // proximity sensor backend instance that provided the distance
     LowPassFilterFloat _filtered_distance[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS]; // low pass filter
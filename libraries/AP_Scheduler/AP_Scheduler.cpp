@@ -287,7 +287,8 @@ void AP_Scheduler::run(uint32_t time_available)
                   (unsigned)_task_time_allowed);
         }
 
-        perf_info.update_task_info(i, time_taken, overrun);
+        const uint32_t start_us = _task_time_started - uint32_t(_loop_sample_time_us);
+        perf_info.update_task_info(i, time_taken, MIN(start_us, UINT16_MAX), overrun);
 
         if (time_taken >= time_available) {
             /*
@@ -438,6 +439,9 @@ void AP_Scheduler::update_logging()
     if (_log_performance_bit != (uint32_t)-1 &&
         AP::logger().should_log(_log_performance_bit)) {
         Log_Write_Performance();
+#if AP_SCHEDULER_TASK_HISTOGRAM_ENABLED
+        Log_Write_Task_Histograms();
+#endif
     }
     perf_info.set_loop_rate(get_loop_rate_hz());
     perf_info.reset();
@@ -478,8 +482,61 @@ void AP_Scheduler::Log_Write_Performance()
     };
     AP::logger().WriteCriticalBlock(&pkt, sizeof(pkt));
 }
+
+#if AP_SCHEDULER_TASK_HISTOGRAM_ENABLED
+// write run time histograms for each task which ran since the last reset
+void AP_Scheduler::Log_Write_Task_Histograms()
+{
+    const uint64_t now_us = AP_HAL::micros64();
+    for (uint8_t i = 0; i < _num_tasks; i++) {
+        const AP::PerfInfo::TaskInfo* ti = perf_info.get_task_info(i);
+        if (ti == nullptr || ti->tick_count == 0) {
+            continue;
+        }
+        struct log_TaskHist pkt {
+            LOG_PACKET_HEADER_INIT(LOG_TSKH_MSG),
+            time_us    : now_us,
+            task_index : i,
+            name       : {},
+            jitter_us  : ti->start_jitter_us(),
+            hist       : {},
+        };
+        strncpy_noterm(pkt.name, task_name(i), sizeof(pkt.name));
+        static_assert(ARRAY_SIZE(pkt.hist) == AP::PerfInfo::TASK_HIST_BINS, "TSKH bins");
+        memcpy(pkt.hist, ti->time_hist, sizeof(pkt.hist));
+        AP::logger().WriteBlock(&pkt, sizeof(pkt));
+    }
+}
+#endif
 #endif  // HAL_LOGGING_ENABLED
 
+/*
+  return the name of a task, with tasks numbered in the order run()
+  walks them
+ */
+const char *AP_Scheduler::task_name(uint8_t task_index) const
+{
+    uint8_t vehicle_tasks_offset = 0;
+    uint8_t common_tasks_offset = 0;
+
+    for (uint8_t i = 0; i < _num_tasks; i++) {
+        // determine which of the common task / vehicle task is next.
+        // In case of a tie the vehicle-specific entry wins.
+        bool vehicle_task;
+        if (vehicle_tasks_offset < _num_vehicle_tasks &&
+            common_tasks_offset < _num_common_tasks) {
+            vehicle_task = _vehicle_tasks[vehicle_tasks_offset].priority <= _common_tasks[common_tasks_offset].priority;
+        } else {
+            vehicle_task = vehicle_tasks_offset < _num_vehicle_tasks;
+        }
+        const char *name = vehicle_task ? _vehicle_tasks[vehicle_tasks_offset++].name : _common_tasks[common_tasks_offset++].name;
+        if (i == task_index) {
+            return name;
+        }
+    }
+    return "";
+}
+
 // display task statistics as text buffer for @SYS/tasks.txt
 void AP_Scheduler::task_info(ExpandingString &str)
 {
@@ -505,46 +562,75 @@ void AP_Scheduler::task_info(ExpandingString &str)
         }
     }
 
-    uint8_t vehicle_tasks_offset = 0;
-    uint8_t common_tasks_offset = 0;
-
     for (uint8_t i = 0; i < _num_tasks; i++) {
         const AP::PerfInfo::TaskInfo* ti = perf_info.get_task_info(i);
-        const char *task_name;
+        ti->print(task_name(i), total_time, str);
+    }
+}
 
-        // determine which of the common task / vehicle task to run
-        bool run_vehicle_task = false;
-        if (vehicle_tasks_offset < _num_vehicle_tasks &&
-            common_tasks_offset < _num_common_tasks) {
-            // still have entries on both lists; compare the
-            // priorities.  In case of a tie the vehicle-specific
-            // entry wins.
-            const Task &vehicle_task = _vehicle_tasks[vehicle_tasks_offset];
-            const Task &common_task = _common_tasks[common_tasks_offset];
-            if (vehicle_task.priority <= common_task.priority) {
-                run_vehicle_task = true;
-            }
-        } else if (vehicle_tasks_offset < _num_vehicle_tasks) {
-            // out of common tasks to run
-            run_vehicle_task = true;
-        } else if (common_tasks_offset < _num_common_tasks) {
-            // out of vehicle tasks to run
-            run_vehicle_task = false;
-        } else {
-            // this is an error; the outside loop should have terminated
-            INTERNAL_ERROR(AP_InternalError::error_t::flow_of_control);
+#if AP_SCHEDULER_TASK_HISTOGRAM_ENABLED
+// display task run time histograms as text buffer for @SYS/task_hist.txt
+void AP_Scheduler::task_hist_info(ExpandingString &str)
+{
+    str.printf("TaskHistV1\n");
+
+    // dynamically enable statistics collection
+    if (!(_options & uint8_t(Options::RECORD_TASK_INFO))) {
+        _options.set(_options | uint8_t(Options::RECORD_TASK_INFO));
+        return;
+    }
+
+    // column headings give the upper end of each bin in microseconds
+#if AP_SCHEDULER_EXTENDED_TASKINFO_ENABLED
+    str.printf("%-32.32s         ", "BIN");
+#else
+    str.printf("%-16.16s         ", "BIN");
+#endif
+    for (uint8_t b = 0; b < AP::PerfInfo::TASK_HIST_BINS-1; b++) {
+        str.printf(" %5u", 16U << b);
+    }
+    str.printf("   inf\n");
+
+    for (uint8_t i = 0; i < _num_tasks; i++) {
+        const AP::PerfInfo::TaskInfo* ti = perf_info.get_task_info(i);
+        if (ti == nullptr) {
             return;
         }
+        ti->print_hist(task_name(i), str);
+    }
+}
+#endif
 
-        if (run_vehicle_task) {
-            task_name = _vehicle_tasks[vehicle_tasks_offset++].name;
-        } else {
-            task_name = _common_tasks[common_tasks_offset++].name;
-        }
+#if AP_SCHEDULER_LOOP_TRACE_EVENTS
+/*
+  display the most recent loops for @SYS/loop_trace.txt. Each loop is
+  the list of tasks it ran with their start time within the loop and
+  run time, followed by the loop time
+ */
+void AP_Scheduler::loop_trace_info(ExpandingString &str)
+{
+    str.printf("LoopTraceV1\n");
+
+    // dynamically enable statistics collection
+    if (!(_options & uint8_t(Options::RECORD_TASK_INFO))) {
+        _options.set(_options | uint8_t(Options::RECORD_TASK_INFO));
+        return;
+    }
 
-        ti->print(task_name, total_time, str);
+    // skip the partial loop at the start of the trace
+    uint16_t i = 0;
+    const AP::PerfInfo::TraceEvent *ev;
+    while ((ev = perf_info.get_trace_event(i++)) != nullptr && ev->task_index != AP::PerfInfo::LOOP_END) {
+    }
+    while ((ev = perf_info.get_trace_event(i++)) != nullptr) {
+        if (ev->task_index == AP::PerfInfo::LOOP_END) {
+            str.printf("LOOP %u\n", unsigned(ev->time_us));
+            continue;
+        }
+        str.printf("  %5u %5u %s\n", unsigned(ev->start_us), unsigned(ev->time_us), task_name(ev->task_index));
     }
 }
+#endif
 
 namespace AP {
 
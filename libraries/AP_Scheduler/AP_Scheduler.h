@@ -115,6 +115,10 @@ public:
 
     // write out PERF message to logger
     void Log_Write_Performance();
+#if AP_SCHEDULER_TASK_HISTOGRAM_ENABLED
+    // write out TSKH messages to logger
+    void Log_Write_Task_Histograms();
+#endif
 
     // call when one tick has passed
     void tick(void);
@@ -189,6 +193,12 @@ public:
     HAL_Semaphore &get_semaphore(void) { return _rsem; }
 
     void task_info(ExpandingString &str);
+#if AP_SCHEDULER_TASK_HISTOGRAM_ENABLED
+    void task_hist_info(ExpandingString &str);
+#endif
+#if AP_SCHEDULER_LOOP_TRACE_EVENTS
+    void loop_trace_info(ExpandingString &str);
+#endif
 
     static const struct AP_Param::GroupInfo var_info[];
 
@@ -196,6 +206,9 @@ public:
     AP::PerfInfo perf_info;
 
 private:
+    // name of a task by its index in the run order
+    const char *task_name(uint8_t task_index) const;
+
     // used to enable scheduler debugging
     AP_Int8 _debug;
 
@@ -9,3 +9,19 @@
 #ifndef AP_SCHEDULER_EXTENDED_TASKINFO_ENABLED
 #define AP_SCHEDULER_EXTENDED_TASKINFO_ENABLED 1
 #endif
+
+// per-task run time histograms and start jitter, collected along
+// with the other task statistics when SCHED_OPTIONS enables them
+#ifndef AP_SCHEDULER_TASK_HISTOGRAM_ENABLED
+#define AP_SCHEDULER_TASK_HISTOGRAM_ENABLED 1
+#endif
+
+// number of task runs kept in the trace of recent loops shown in
+// @SYS/loop_trace.txt, zero to disable
+#ifndef AP_SCHEDULER_LOOP_TRACE_EVENTS
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_1000
+#define AP_SCHEDULER_LOOP_TRACE_EVENTS 512
+#else
+#define AP_SCHEDULER_LOOP_TRACE_EVENTS 0
+#endif
+#endif
@@ -52,6 +52,12 @@ void AP::PerfInfo::allocate_task_info(uint8_t num_tasks)
         return;
     }
     _num_tasks = num_tasks;
+#if AP_SCHEDULER_LOOP_TRACE_EVENTS
+    // the trace is optional, task statistics work without it
+    _trace = NEW_NOTHROW TraceEvent[AP_SCHEDULER_LOOP_TRACE_EVENTS];
+    _trace_head = 0;
+    _trace_wrapped = false;
+#endif
 }
 
 void AP::PerfInfo::free_task_info()
@@ -59,10 +65,46 @@ void AP::PerfInfo::free_task_info()
     delete[] _task_info;
     _task_info = nullptr;
     _num_tasks = 0;
+#if AP_SCHEDULER_LOOP_TRACE_EVENTS
+    delete[] _trace;
+    _trace = nullptr;
+#endif
+}
+
+#if AP_SCHEDULER_LOOP_TRACE_EVENTS
+void AP::PerfInfo::add_trace_event(uint8_t task_index, uint16_t start_us, uint16_t time_us)
+{
+    if (_trace == nullptr) {
+        return;
+    }
+    TraceEvent &ev = _trace[_trace_head];
+    ev.task_index = task_index;
+    ev.start_us = start_us;
+    ev.time_us = time_us;
+    _trace_head++;
+    if (_trace_head >= AP_SCHEDULER_LOOP_TRACE_EVENTS) {
+        _trace_head = 0;
+        _trace_wrapped = true;
+    }
 }
 
+const AP::PerfInfo::TraceEvent *AP::PerfInfo::get_trace_event(uint16_t index) const
+{
+    if (_trace == nullptr) {
+        return nullptr;
+    }
+    if (!_trace_wrapped) {
+        return index < _trace_head ? &_trace[index] : nullptr;
+    }
+    if (index >= AP_SCHEDULER_LOOP_TRACE_EVENTS) {
+        return nullptr;
+    }
+    return &_trace[(_trace_head + index) % AP_SCHEDULER_LOOP_TRACE_EVENTS];
+}
+#endif // AP_SCHEDULER_LOOP_TRACE_EVENTS
+
 // called after each run of a task to update its statistics based on measurements taken by the scheduler
-void AP::PerfInfo::update_task_info(uint8_t task_index, uint16_t task_time_us, bool overrun)
+void AP::PerfInfo::update_task_info(uint8_t task_index, uint16_t task_time_us, uint16_t start_us, bool overrun)
 {
     if (_task_info == nullptr) {
         return;
@@ -73,11 +115,31 @@ void AP::PerfInfo::update_task_info(uint8_t task_index, uint16_t task_time_us, b
         return;
     }
     TaskInfo& ti = _task_info[task_index];
-    ti.update(task_time_us, overrun);
+    ti.update(task_time_us, start_us, overrun);
+#if AP_SCHEDULER_LOOP_TRACE_EVENTS
+    add_trace_event(task_index, start_us, task_time_us);
+#endif
 }
 
-void AP::PerfInfo::TaskInfo::update(uint16_t task_time_us, bool overrun)
+void AP::PerfInfo::TaskInfo::update(uint16_t task_time_us, uint16_t start_us, bool overrun)
 {
+#if AP_SCHEDULER_TASK_HISTOGRAM_ENABLED
+    if (tick_count == 0) {
+        min_start_us = start_us;
+        max_start_us = start_us;
+    } else {
+        min_start_us = MIN(min_start_us, start_us);
+        max_start_us = MAX(max_start_us, start_us);
+    }
+    uint8_t bin = 0;
+    for (uint16_t t = task_time_us >> 4; t != 0 && bin < TASK_HIST_BINS-1; t >>= 1) {
+        bin++;
+    }
+    if (time_hist[bin] < UINT16_MAX) {
+        time_hist[bin]++;
+    }
+#endif
+
     max_time_us = MAX(max_time_us, task_time_us);
     if (min_time_us == 0) {
         min_time_us = task_time_us;
@@ -109,11 +171,30 @@ void AP::PerfInfo::TaskInfo::print(const char* task_name, uint32_t total_time, E
                 unsigned(MIN(overrun_count, 999)), unsigned(MIN(slip_count, 999)), pct);
 }
 
+#if AP_SCHEDULER_TASK_HISTOGRAM_ENABLED
+void AP::PerfInfo::TaskInfo::print_hist(const char* task_name, ExpandingString& str) const
+{
+#if AP_SCHEDULER_EXTENDED_TASKINFO_ENABLED
+    str.printf("%-32.32s JIT=%4u", task_name, unsigned(MIN(start_jitter_us(), 9999)));
+#else
+    str.printf("%-16.16s JIT=%4u", task_name, unsigned(MIN(start_jitter_us(), 9999)));
+#endif
+    for (uint8_t i=0; i<TASK_HIST_BINS; i++) {
+        str.printf(" %5u", unsigned(time_hist[i]));
+    }
+    str.printf("\n");
+}
+#endif // AP_SCHEDULER_TASK_HISTOGRAM_ENABLED
+
 // check_loop_time - check latest loop time vs min, max and overtime threshold
 void AP::PerfInfo::check_loop_time(uint32_t time_in_micros)
 {
     loop_count++;
 
+#if AP_SCHEDULER_LOOP_TRACE_EVENTS
+    add_trace_event(LOOP_END, 0, MIN(time_in_micros, UINT16_MAX));
+#endif
+
     // exit if this loop should be ignored
     if (ignore_loop) {
         ignore_loop = false;
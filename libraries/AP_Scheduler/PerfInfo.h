@@ -13,6 +13,13 @@ class PerfInfo {
 public:
     PerfInfo() {}
 
+#if AP_SCHEDULER_TASK_HISTOGRAM_ENABLED
+    // run time histogram bins. Bin 0 counts runs under 16us, each
+    // following bin is twice as wide and the last bin counts all runs
+    // of 4096us or more
+    static constexpr uint8_t TASK_HIST_BINS = 10;
+#endif
+
     // per-task timing information
     struct TaskInfo {
         uint16_t min_time_us;
@@ -21,11 +28,35 @@ public:
         uint32_t tick_count;
         uint16_t slip_count;
         uint16_t overrun_count;
+#if AP_SCHEDULER_TASK_HISTOGRAM_ENABLED
+        // earliest and latest start relative to the start of the loop
+        uint16_t min_start_us;
+        uint16_t max_start_us;
+        uint16_t time_hist[TASK_HIST_BINS];
+
+        // spread of start times within the loop
+        uint16_t start_jitter_us() const {
+            return tick_count > 0 ? max_start_us - min_start_us : 0;
+        }
+        void print_hist(const char* task_name, ExpandingString& str) const;
+#endif
 
-        void update(uint16_t task_time_us, bool overrun);
+        void update(uint16_t task_time_us, uint16_t start_us, bool overrun);
         void print(const char* task_name, uint32_t total_time, ExpandingString& str) const;
     };
 
+#if AP_SCHEDULER_LOOP_TRACE_EVENTS
+    // one task run in the trace of recent loops
+    struct TraceEvent {
+        uint8_t task_index;     // LOOP_END for the end of a loop
+        uint16_t start_us;      // start relative to the start of the loop
+        uint16_t time_us;       // run time, or loop time for LOOP_END
+    };
+    static constexpr uint8_t LOOP_END = 0xFF;
+    // return a trace event, index 0 being the oldest
+    const TraceEvent *get_trace_event(uint16_t index) const;
+#endif
+
     /* Do not allow copies */
     CLASS_NO_COPY(PerfInfo);
 
@@ -54,7 +85,7 @@ public:
         return (_task_info && task_index < _num_tasks) ? &_task_info[task_index] : nullptr;
     }
     // called after each run of a task to update its statistics based on measurements taken by the scheduler
-    void update_task_info(uint8_t task_index, uint16_t task_time_us, bool overrun);
+    void update_task_info(uint8_t task_index, uint16_t task_time_us, uint16_t start_us, bool overrun);
     // record that a task slipped
     void task_slipped(uint8_t task_index) {
         if (_task_info && task_index < _num_tasks) {
@@ -77,6 +108,12 @@ private:
     // performance monitoring
     uint8_t _num_tasks;
     TaskInfo* _task_info;
+#if AP_SCHEDULER_LOOP_TRACE_EVENTS
+    TraceEvent* _trace;
+    uint16_t _trace_head;   // next event to write
+    bool _trace_wrapped;
+    void add_trace_event(uint8_t task_index, uint16_t start_us, uint16_t time_us);
+#endif
 };
 
 };
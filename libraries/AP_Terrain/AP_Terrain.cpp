@@ -390,6 +390,7 @@ void AP_Terrain::update(void)
     // update tiles surrounding our current location:
     if (pos_valid) {
         have_surrounding_tiles = update_surrounding_tiles(loc);
+        update_mission_lookahead(loc);
     } else {
         have_surrounding_tiles = false;
     }
@@ -23,6 +23,9 @@
 #include <AP_Param/AP_Param.h>
 #include <GCS_MAVLink/GCS_MAVLink.h>
 #include <AP_Logger/AP_Logger_config.h>
+#if AP_TERRAIN_MMAP_ENABLED
+#include <AP_HAL/Semaphores.h>
+#endif
 
 #define TERRAIN_DEBUG 0
 
@@ -306,6 +309,13 @@ private:
     */
     struct grid_cache &find_grid_cache(const struct grid_info &info);
 
+    /*
+      find a grid structure for prefetching, only replacing a block
+      that is clean and not in use
+    */
+    bool prefetch_grid_cache(const struct grid_info &info, uint32_t min_age_ms);
+    void init_grid_cache(struct grid_cache &grid, const struct grid_info &info);
+
     /*
       calculate bit number in grid_block bitmap. This corresponds to a
       bit representing a 4x4 mavlink transmitted block
@@ -347,8 +357,14 @@ private:
     void open_file(void);
     void seek_offset(void);
     uint32_t east_blocks(struct grid_block &block) const;
+    uint32_t block_file_offset(struct grid_block &block) const;
+    bool block_matches(struct grid_block &block, int32_t lat, int32_t lon);
     void write_block(void);
     void read_block(void);
+#if AP_TERRAIN_MMAP_ENABLED
+    void map_file(void);
+    bool fill_from_map(struct grid_cache &gcache);
+#endif
 
     // check for missing data in squares surrounding loc:
     bool update_surrounding_tiles(const Location &loc);
@@ -358,6 +374,11 @@ private:
      */
     void update_mission_data(void);
 
+    /*
+      prefetch grid blocks along the upcoming mission legs
+     */
+    void update_mission_lookahead(const Location &loc);
+
     /*
       check for missing rally data
      */
@@ -396,6 +417,29 @@ private:
     volatile enum DiskIoState disk_io_state;
     union grid_io_block disk_block;
 
+    // position of the block handed to the IO thread. The IO thread
+    // reads into disk_block, so the main thread uses this copy
+    int32_t disk_io_lat;
+    int32_t disk_io_lon;
+    bool block_in_disk_io(const struct grid_block &grid) const;
+
+#if AP_TERRAIN_MMAP_ENABLED
+    /*
+      read-only mappings of the terrain files. Cache misses are filled
+      straight from a mapping when the block is already resident in
+      memory, so lookups don't wait for the IO thread. Mappings are
+      created and replaced by the IO thread
+     */
+    struct mapped_file {
+        const uint8_t *base;
+        size_t size;
+        int8_t lat_degrees;
+        int16_t lon_degrees;
+    } mapped_files[AP_TERRAIN_MMAP_MAX_FILES];
+    uint8_t next_mapped_file;
+    HAL_Semaphore mmap_sem;
+#endif
+
 #if HAL_GCS_ENABLED
     // last time we asked for more grids
     uint32_t last_request_time_ms[MAVLINK_COMM_NUM_BUFFERS];
@@ -456,6 +500,9 @@ private:
     // grid spacing during mission check
     uint16_t last_mission_spacing;
 
+    // last time blocks along the upcoming mission legs were prefetched
+    uint32_t last_lookahead_ms;
+
     // next rally command to check
     uint16_t next_rally_index;
 
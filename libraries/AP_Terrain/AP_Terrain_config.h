@@ -6,3 +6,13 @@
 #ifndef AP_TERRAIN_AVAILABLE
 #define AP_TERRAIN_AVAILABLE AP_FILESYSTEM_FILE_READING_ENABLED
 #endif
+
+// fill cache misses straight from memory mapped terrain files on POSIX filesystems
+#ifndef AP_TERRAIN_MMAP_ENABLED
+#define AP_TERRAIN_MMAP_ENABLED (AP_TERRAIN_AVAILABLE && (CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX))
+#endif
+
+// number of terrain files (one per degree square) kept mapped at once
+#ifndef AP_TERRAIN_MMAP_MAX_FILES
+#define AP_TERRAIN_MMAP_MAX_FILES 4
+#endif
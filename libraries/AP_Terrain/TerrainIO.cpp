@@ -26,6 +26,13 @@
 #include <AP_Math/AP_Math.h>
 #include <stdio.h>
 
+#if AP_TERRAIN_MMAP_ENABLED
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 extern const AP_HAL::HAL& hal;
 
 /*
@@ -36,6 +43,8 @@ void AP_Terrain::check_disk_read(void)
     for (uint16_t i=0; i<cache_size; i++) {
         if (cache[i].state == GRID_CACHE_DISKWAIT) {
             disk_block.block = cache[i].grid;
+            disk_io_lat = cache[i].grid.lat;
+            disk_io_lon = cache[i].grid.lon;
             disk_io_state = DiskIoWaitRead;
             return;
         }
@@ -50,12 +59,26 @@ void AP_Terrain::check_disk_write(void)
     for (uint16_t i=0; i<cache_size; i++) {
         if (cache[i].state == GRID_CACHE_DIRTY) {
             disk_block.block = cache[i].grid;
+            disk_io_lat = cache[i].grid.lat;
+            disk_io_lon = cache[i].grid.lon;
             disk_io_state = DiskIoWaitWrite;
             return;
         }
     }    
 }
 
+/*
+  return true if the IO thread is reading or writing this block. Only
+  called from the main thread, which is the only writer of
+  disk_io_lat/disk_io_lon
+ */
+bool AP_Terrain::block_in_disk_io(const struct grid_block &grid) const
+{
+    return disk_io_state != DiskIoIdle &&
+        TERRAIN_LATLON_EQUAL(disk_io_lat, grid.lat) &&
+        TERRAIN_LATLON_EQUAL(disk_io_lon, grid.lon);
+}
+
 /*
   Check if we need to do disk IO for grids. 
  */
@@ -72,14 +95,8 @@ void AP_Terrain::schedule_disk_io(void)
 
     switch (disk_io_state) {
     case DiskIoIdle:
-        // look for a block that needs reading or writing
-        check_disk_read();
-        if (disk_io_state == DiskIoIdle) {
-            // still idle, check for writes
-            check_disk_write();            
-        }
         break;
-        
+
     case DiskIoDoneRead: {
         // a read has completed
         int16_t cache_idx = find_io_idx(GRID_CACHE_DISKWAIT);
@@ -111,10 +128,90 @@ void AP_Terrain::schedule_disk_io(void)
     case DiskIoWaitWrite:
     case DiskIoWaitRead:
         // waiting for io_timer()
-        break;
+        return;
+    }
+
+    // start the next read or write straight away rather than on the
+    // next call, so a run of blocks loads at the rate of the caller
+    // look for a block that needs reading or writing
+    check_disk_read();
+    if (disk_io_state == DiskIoIdle) {
+        // still idle, check for writes
+        check_disk_write();
     }
 }
 
+#if AP_TERRAIN_MMAP_ENABLED
+/*
+  fill a cache block waiting for disk IO from the mapped degree file.
+  This runs in the main thread so only uses blocks already resident
+  in memory, leaving anything else to the IO thread
+ */
+bool AP_Terrain::fill_from_map(struct grid_cache &gcache)
+{
+    struct grid_block &grid = gcache.grid;
+
+    // leave the block alone if the IO thread is already working on it
+    if (block_in_disk_io(grid)) {
+        return false;
+    }
+
+    if (!mmap_sem.take_nonblocking()) {
+        return false;
+    }
+
+    bool ret = false;
+    for (const auto &mf : mapped_files) {
+        if (mf.base == nullptr ||
+            mf.lat_degrees != grid.lat_degrees ||
+            mf.lon_degrees != grid.lon_degrees) {
+            continue;
+        }
+        const uint32_t file_offset = block_file_offset(grid);
+        if (file_offset + sizeof(union grid_io_block) > mf.size) {
+            // beyond the end of the file when it was mapped
+            break;
+        }
+
+        // check the pages holding the block are resident so we never
+        // wait on the disk here
+        const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+        const uint8_t *block_ptr = mf.base + file_offset;
+        uint8_t *page = (uint8_t *)((uintptr_t)block_ptr & ~(page_size - 1));
+        const size_t len = (block_ptr + sizeof(union grid_io_block)) - page;
+#if defined(__APPLE__)
+        char resident[4];
+#else
+        unsigned char resident[4];
+#endif
+        if (len > sizeof(resident) * page_size || mincore(page, len, resident) != 0) {
+            break;
+        }
+        bool all_resident = true;
+        for (uint8_t i=0; i<(len + page_size - 1) / page_size; i++) {
+            if ((resident[i] & 1) == 0) {
+                all_resident = false;
+            }
+        }
+        if (!all_resident) {
+            break;
+        }
+
+        union grid_io_block io_block;
+        memcpy(&io_block, block_ptr, sizeof(io_block));
+        if (block_matches(io_block.block, grid.lat, grid.lon)) {
+            grid = io_block.block;
+        }
+        // a missing block is left empty, just as when the IO thread reads it
+        gcache.state = GRID_CACHE_VALID;
+        ret = true;
+        break;
+    }
+
+    mmap_sem.give();
+    return ret;
+}
+#endif  // AP_TERRAIN_MMAP_ENABLED
 
 /********************************************************
 All the functions below this point run in the IO timer context, which
@@ -212,6 +309,10 @@ void AP_Terrain::open_file(void)
 
     file_lat_degrees = block.lat_degrees;
     file_lon_degrees = block.lon_degrees;
+
+#if AP_TERRAIN_MMAP_ENABLED
+    map_file();
+#endif
 }
 
 /*
@@ -232,14 +333,34 @@ uint32_t AP_Terrain::east_blocks(struct grid_block &block) const
 }
 
 /*
-  seek to the right offset for disk_block
+  return the offset of a block within its degree file
  */
-void AP_Terrain::seek_offset(void)
+uint32_t AP_Terrain::block_file_offset(struct grid_block &block) const
 {
-    struct grid_block &block = disk_block.block;
     // work out how many longitude blocks there are at this latitude
     uint32_t blocknum = east_blocks(block) * block.grid_idx_x + block.grid_idx_y;
-    uint32_t file_offset = blocknum * sizeof(union grid_io_block);
+    return blocknum * sizeof(union grid_io_block);
+}
+
+/*
+  check a block read from disk is the block at lat/lon and is intact
+ */
+bool AP_Terrain::block_matches(struct grid_block &block, int32_t lat, int32_t lon)
+{
+    return TERRAIN_LATLON_EQUAL(block.lat,lat) &&
+        TERRAIN_LATLON_EQUAL(block.lon,lon) &&
+        block.bitmap != 0 &&
+        block.spacing == grid_spacing &&
+        block.version == TERRAIN_GRID_FORMAT_VERSION &&
+        block.crc == get_block_crc(block);
+}
+
+/*
+  seek to the right offset for disk_block
+ */
+void AP_Terrain::seek_offset(void)
+{
+    uint32_t file_offset = block_file_offset(disk_block.block);
     if (AP::FS().lseek(fd, file_offset, SEEK_SET) != (off_t)file_offset) {
 #if TERRAIN_DEBUG
         hal.console->printf("Seek %lu failed - %s\n",
@@ -273,6 +394,23 @@ void AP_Terrain::write_block(void)
         io_failure = true;
     } else {
         AP::FS().fsync(fd);
+#if AP_TERRAIN_MMAP_ENABLED
+        // remap if the file has grown past the end of its mapping
+        const uint32_t block_end = block_file_offset(disk_block.block) + sizeof(disk_block);
+        bool mapped = false;
+        for (const auto &mf : mapped_files) {
+            if (mf.base != nullptr &&
+                mf.lat_degrees == file_lat_degrees &&
+                mf.lon_degrees == file_lon_degrees &&
+                mf.size >= block_end) {
+                mapped = true;
+                break;
+            }
+        }
+        if (!mapped) {
+            map_file();
+        }
+#endif
 #if TERRAIN_DEBUG
         printf("wrote block at %ld %ld ret=%d mask=%07llx\n",
                (long)disk_block.block.lat,
@@ -298,12 +436,7 @@ void AP_Terrain::read_block(void)
 
     ssize_t ret = AP::FS().read(fd, &disk_block, sizeof(disk_block));
     if (ret != sizeof(disk_block) || 
-        !TERRAIN_LATLON_EQUAL(disk_block.block.lat,lat) ||
-        !TERRAIN_LATLON_EQUAL(disk_block.block.lon,lon) ||
-        disk_block.block.bitmap == 0 ||
-        disk_block.block.spacing != grid_spacing ||
-        disk_block.block.version != TERRAIN_GRID_FORMAT_VERSION ||
-        disk_block.block.crc != get_block_crc(disk_block.block)) {
+        !block_matches(disk_block.block, lat, lon)) {
 #if TERRAIN_DEBUG
         printf("read empty block at %ld %ld ret=%d (%ld %ld %u 0x%08lx) 0x%04x:0x%04x\n",
                (long)lat,
@@ -334,6 +467,60 @@ void AP_Terrain::read_block(void)
     disk_io_state = DiskIoDoneRead;
 }
 
+#if AP_TERRAIN_MMAP_ENABLED
+/*
+  map the open degree file read-only, replacing any older mapping of
+  the same file or else the oldest mapping
+ */
+void AP_Terrain::map_file(void)
+{
+    const int map_fd = ::open(file_path, O_RDONLY | O_CLOEXEC);
+    if (map_fd == -1) {
+        return;
+    }
+    struct stat st;
+    if (fstat(map_fd, &st) != 0 || st.st_size < (off_t)sizeof(union grid_io_block)) {
+        ::close(map_fd);
+        return;
+    }
+    void *base = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, map_fd, 0);
+    ::close(map_fd);
+    if (base == MAP_FAILED) {
+        return;
+    }
+
+    // start reading the file into memory in the background
+    madvise(base, st.st_size, MADV_WILLNEED);
+
+    WITH_SEMAPHORE(mmap_sem);
+
+    uint8_t idx = next_mapped_file;
+    bool found = false;
+    for (uint8_t i=0; i<ARRAY_SIZE(mapped_files); i++) {
+        if (mapped_files[i].base != nullptr &&
+            mapped_files[i].lat_degrees == file_lat_degrees &&
+            mapped_files[i].lon_degrees == file_lon_degrees) {
+            idx = i;
+            found = true;
+            break;
+        }
+    }
+    if (!found) {
+        next_mapped_file = (next_mapped_file + 1) % ARRAY_SIZE(mapped_files);
+    }
+
+    struct mapped_file &mf = mapped_files[idx];
+    if (mf.base != nullptr) {
+        munmap((void *)mf.base, mf.size);
+    }
+    mf.base = (const uint8_t *)base;
+    mf.size = st.st_size;
+    mf.lat_degrees = file_lat_degrees;
+    mf.lon_degrees = file_lon_degrees;
+}
+
+#endif  // AP_TERRAIN_MMAP_ENABLED
+
 /*
   timer called to do disk IO
  */
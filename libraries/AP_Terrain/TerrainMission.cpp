@@ -29,6 +29,9 @@
 
 extern const AP_HAL::HAL& hal;
 
+// how often blocks along the mission legs are prefetched
+#define TERRAIN_LOOKAHEAD_PERIOD_MS 1000
+
 /*
   check that we have fetched all mission terrain data
  */
@@ -114,6 +117,98 @@ void AP_Terrain::update_mission_data(void)
 #endif  // AP_MISSION_ENABLED
 }
 
+/*
+  prefetch the grid blocks along the current and next mission legs
+  so they are read from disk (or requested from the GCS) before the
+  vehicle reaches them. The blocks around the vehicle only cover a
+  little over one block in each direction which a fast plane can
+  cross in well under a minute
+ */
+void AP_Terrain::update_mission_lookahead(const Location &loc)
+{
+#if AP_MISSION_ENABLED
+    const AP_Mission *mission = AP::mission();
+    if (mission == nullptr || mission->state() != AP_Mission::MISSION_RUNNING) {
+        return;
+    }
+
+    // don't spend more than a quarter of the cache on one pass
+    const uint8_t max_blocks = cache_size / 4;
+    if (max_blocks == 0) {
+        return;
+    }
+
+    // once a second is plenty as each leg covers many blocks
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - last_lookahead_ms < TERRAIN_LOOKAHEAD_PERIOD_MS) {
+        return;
+    }
+    last_lookahead_ms = now_ms;
+
+    // legs run from the vehicle to the current nav target and on to
+    // the next waypoint
+    const AP_Mission::Mission_Command &nav_cmd = mission->get_current_nav_cmd();
+    if (nav_cmd.content.location.lat == 0 && nav_cmd.content.location.lng == 0) {
+        return;
+    }
+    Location points[3];
+    uint8_t num_points = 0;
+    points[num_points++] = loc;
+    points[num_points++] = nav_cmd.content.location;
+    for (uint16_t idx = mission->get_current_nav_index() + 1; idx < mission->num_commands(); idx++) {
+        AP_Mission::Mission_Command cmd;
+        if (!mission->read_cmd_from_storage(idx, cmd)) {
+            break;
+        }
+        if (!AP_Mission::is_nav_cmd(cmd)) {
+            continue;
+        }
+        if ((cmd.id == MAV_CMD_NAV_WAYPOINT || cmd.id == MAV_CMD_NAV_SPLINE_WAYPOINT) &&
+            (cmd.content.location.lat != 0 || cmd.content.location.lng != 0)) {
+            points[num_points++] = cmd.content.location;
+        }
+        break;
+    }
+
+    // sample the legs at half a block spacing so no block along the
+    // path is skipped
+    const float step_m = MIN(TERRAIN_GRID_BLOCK_SPACING_X, TERRAIN_GRID_BLOCK_SPACING_Y) * grid_spacing * 0.5f;
+    if (step_m <= 0) {
+        return;
+    }
+    uint8_t num_blocks = 0;
+    int32_t last_grid_lat = 0;
+    int32_t last_grid_lon = 0;
+    for (uint8_t i=0; i<num_points-1; i++) {
+        const float leg_length_m = points[i].get_distance(points[i+1]);
+        const float bearing_deg = points[i].get_bearing_to(points[i+1]) * 0.01f;
+        for (float dist_m = 0; dist_m < leg_length_m + step_m; dist_m += step_m) {
+            Location sample = points[i];
+            sample.offset_bearing(bearing_deg, MIN(dist_m, leg_length_m));
+            struct grid_info info;
+            calculate_grid_info(sample, info);
+            if (info.grid_lat == last_grid_lat && info.grid_lon == last_grid_lon) {
+                continue;
+            }
+            last_grid_lat = info.grid_lat;
+            last_grid_lon = info.grid_lon;
+
+            // looking up the block marks it as recently used, and
+            // queues a disk read if it is not already in the cache.
+            // Blocks used since the last pass are the working set of
+            // the vehicle and are never replaced, so stop once the
+            // cache has no other room
+            if (!prefetch_grid_cache(info, TERRAIN_LOOKAHEAD_PERIOD_MS)) {
+                return;
+            }
+            if (++num_blocks >= max_blocks) {
+                return;
+            }
+        }
+    }
+#endif  // AP_MISSION_ENABLED
+}
+
 #if HAL_RALLY_ENABLED
 /*
   check that we have fetched all rally terrain data
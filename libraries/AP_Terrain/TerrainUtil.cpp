@@ -125,6 +125,56 @@ AP_Terrain::grid_cache &AP_Terrain::find_grid_cache(const struct grid_info &info
     // Not found. Use the oldest grid and make it this grid,
     // initially unpopulated
     struct grid_cache &grid = cache[oldest_i];
+    init_grid_cache(grid, info);
+    return grid;
+}
+
+/*
+  find a grid structure for prefetching. Unlike find_grid_cache() this
+  only replaces a block that is clean, not being read or written by
+  the IO thread and not used within the last min_age_ms, so a prefetch
+  never pushes out blocks the vehicle is using or terrain data from
+  the GCS that is still to be written to disk. Returns false if there
+  is no such block
+ */
+bool AP_Terrain::prefetch_grid_cache(const struct grid_info &info, uint32_t min_age_ms)
+{
+    int16_t oldest_i = -1;
+
+    const auto now_ms = AP_HAL::millis();
+    for (uint16_t i=0; i<cache_size; i++) {
+        if (TERRAIN_LATLON_EQUAL(cache[i].grid.lat,info.grid_lat) &&
+            TERRAIN_LATLON_EQUAL(cache[i].grid.lon,info.grid_lon) &&
+            cache[i].grid.spacing == grid_spacing) {
+            cache[i].last_access_ms = now_ms;
+            return true;
+        }
+        if (cache[i].state != GRID_CACHE_INVALID && cache[i].state != GRID_CACHE_VALID) {
+            continue;
+        }
+        if (now_ms - cache[i].last_access_ms < min_age_ms) {
+            continue;
+        }
+        if (block_in_disk_io(cache[i].grid)) {
+            continue;
+        }
+        if (oldest_i == -1 || cache[i].last_access_ms < cache[oldest_i].last_access_ms) {
+            oldest_i = i;
+        }
+    }
+
+    if (oldest_i == -1) {
+        return false;
+    }
+    init_grid_cache(cache[oldest_i], info);
+    return true;
+}
+
+/*
+  setup a cache entry for the grid in grid_info, waiting for disk read
+ */
+void AP_Terrain::init_grid_cache(struct grid_cache &grid, const struct grid_info &info)
+{
     memset(&grid, 0, sizeof(grid));
 
     grid.grid.lat = info.grid_lat;
@@ -135,12 +185,15 @@ AP_Terrain::grid_cache &AP_Terrain::find_grid_cache(const struct grid_info &info
     grid.grid.lat_degrees = info.lat_degrees;
     grid.grid.lon_degrees = info.lon_degrees;
     grid.grid.version = TERRAIN_GRID_FORMAT_VERSION;
-    grid.last_access_ms = now_ms;
+    grid.last_access_ms = AP_HAL::millis();
 
     // mark as waiting for disk read
     grid.state = GRID_CACHE_DISKWAIT;
 
-    return grid;
+#if AP_TERRAIN_MMAP_ENABLED
+    // try to fill the block from a mapped terrain file without waiting for the IO thread
+    fill_from_map(grid);
+#endif
 }
 
 /*
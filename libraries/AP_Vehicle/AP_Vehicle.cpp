@@ -535,6 +535,11 @@ void AP_Vehicle::setup()
     // initialisation
     AP_Param::invalidate_count();
 
+#if AP_PARAM_NAME_INDEX_ENABLED
+    // pick up the parameters of objects allocated during init
+    AP_Param::build_name_index();
+#endif
+
     GCS_SEND_TEXT(MAV_SEVERITY_INFO, "ArduPilot Ready");
 
 #if AP_DDS_ENABLED
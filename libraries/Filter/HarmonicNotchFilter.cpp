@@ -415,7 +415,12 @@ T HarmonicNotchFilter<T>::apply(const T &sample)
             ::dprintf(dfd, "%.4f ", _filters[i]._center_freq_hz);
         }
 #endif
-        output = _filters[i].apply(output);
+        NotchFilter<T> &filter = _filters[i];
+        if (filter.initialised && !filter.need_reset) {
+            output = filter.apply_initialised(output);
+        } else {
+            output = filter.apply(output);
+        }
     }
 #if NOTCH_DEBUG_LOGGING
     if (_num_enabled_filters > 0) {
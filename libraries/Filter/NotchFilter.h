@@ -53,6 +53,19 @@ public:
 
 protected:
 
+    // apply a sample once initialised. Inline so a bank of notches
+    // can be cascaded without a function call per notch
+    T apply_initialised(const T &sample) {
+        const T output = sample*b0 + ntchsig1*b1 + ntchsig2*b2 - signal1*a1 - signal2*a2;
+
+        ntchsig2 = ntchsig1;
+        ntchsig1 = sample;
+
+        signal2 = signal1;
+        signal1 = output;
+        return output;
+    }
+
     bool initialised, need_reset;
     float b0, b1, b2, a1, a2;
     float _center_freq_hz, _sample_freq_hz, _A;
@@ -0,0 +1,50 @@
+#include <AP_gbenchmark.h>
+
+#include <Filter/HarmonicNotchFilter.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  time the gyro path through a harmonic notch bank, as used with ESC
+  telemetry on an octo: one notch per motor on three harmonics, run
+  with one, two and three notches per harmonic
+ */
+static void BM_HarmonicNotchVector3f(benchmark::State& state)
+{
+    const uint8_t num_motors = 8;
+    const float sample_rate_hz = 8000;
+
+    HarmonicNotchFilterParams params {};
+    uint16_t options = 0;
+    if (state.range(0) == 2) {
+        options = uint16_t(HarmonicNotchFilterParams::Options::DoubleNotch);
+    } else if (state.range(0) == 3) {
+        options = uint16_t(HarmonicNotchFilterParams::Options::TripleNotch);
+    }
+    params.set_options(options);
+    params.set_attenuation(40);
+    params.set_bandwidth_hz(40);
+    params.set_center_freq_hz(80);
+    params.set_harmonics(0x7);
+    params.set_freq_min_ratio(1.0);
+
+    HarmonicNotchFilter<Vector3f> filter {};
+    filter.allocate_filters(num_motors, params.harmonics(), params.num_composite_notches());
+    filter.init(sample_rate_hz, params);
+
+    float motor_freqs[num_motors];
+    for (uint8_t i=0; i<num_motors; i++) {
+        motor_freqs[i] = 90 + 5 * i;
+    }
+    filter.update(num_motors, motor_freqs);
+
+    Vector3f gyro {0.1, -0.2, 0.3};
+    while (state.KeepRunning()) {
+        gyro = filter.apply(gyro);
+        gbenchmark_escape(&gyro);
+    }
+}
+
+BENCHMARK(BM_HarmonicNotchVector3f)->Arg(1)->Arg(2)->Arg(3);
+
+BENCHMARK_MAIN();
@@ -928,7 +928,13 @@ private:
     // return interval deferred message bucket should be sent after.
     // When sending parameters and waypoints this may be longer than
     // the interval specified in "deferred"
-    uint16_t get_reschedule_interval_ms(const deferred_message_bucket_t &deferred) const;
+    uint16_t get_reschedule_interval_ms(const deferred_message_bucket_t &deferred) const {
+        return get_reschedule_interval_ms(deferred, reschedule_interval_multiplier());
+    }
+    uint16_t get_reschedule_interval_ms(const deferred_message_bucket_t &deferred, uint8_t multiplier) const;
+    // factor by which bucket intervals are stretched while parameters,
+    // waypoints or files are being transferred
+    uint8_t reschedule_interval_multiplier() const;
 
     bool do_try_send_message(const ap_message id);
 
@@ -1038,6 +1044,12 @@ private:
         int16_t current_session;
         uint32_t last_send_ms;
         uint8_t need_banner_send_mask;
+#if AP_MAVLINK_FTP_READ_BUFFER_SIZE > 0
+        // read-ahead buffer holding the file contents from read_buf_offset
+        uint8_t *read_buf;
+        uint32_t read_buf_offset;
+        uint16_t read_buf_len;
+#endif
     };
     static struct ftp_state ftp;
 
@@ -1045,6 +1057,7 @@ private:
     static bool ftp_check_name_len(const struct pending_ftp &request);
     static int gen_dir_entry(char *dest, size_t space, const char * path, const struct dirent * entry); // FTP helper for emitting a dir response
     static void ftp_list_dir(struct pending_ftp &request, struct pending_ftp &response);
+    static ssize_t ftp_read(uint32_t offset, uint8_t *data, uint16_t len);
 
     bool ftp_init(void);
     void handle_file_transfer_protocol(const mavlink_message_t &msg);
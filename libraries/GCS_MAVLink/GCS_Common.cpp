@@ -1235,29 +1235,37 @@ bool GCS_MAVLINK::should_send_message_in_delay_callback(const ap_message id) con
     return false;
 }
 
-uint16_t GCS_MAVLINK::get_reschedule_interval_ms(const deferred_message_bucket_t &deferred) const
+uint8_t GCS_MAVLINK::reschedule_interval_multiplier() const
 {
-    uint32_t interval_ms = deferred.interval_ms;
-
-    interval_ms += stream_slowdown_ms;
+    uint8_t multiplier = 1;
 
     // slow most messages down if we're transfering parameters or
     // waypoints:
     if (_queued_parameter) {
         // we are sending parameters, penalize streams:
-        interval_ms *= 4;
+        multiplier *= 4;
     }
     if (requesting_mission_items()) {
         // we are sending requests for waypoints, penalize streams:
-        interval_ms *= 4;
+        multiplier *= 4;
     }
 #if AP_MAVLINK_FTP_ENABLED
     if (AP_HAL::millis() - ftp.last_send_ms < 1000) {
         // we are sending ftp replies
-        interval_ms *= 4;
+        multiplier *= 4;
     }
 #endif
 
+    return multiplier;
+}
+
+uint16_t GCS_MAVLINK::get_reschedule_interval_ms(const deferred_message_bucket_t &deferred, uint8_t multiplier) const
+{
+    uint32_t interval_ms = deferred.interval_ms;
+
+    interval_ms += stream_slowdown_ms;
+    interval_ms *= multiplier;
+
     if (interval_ms > 60000) {
         return 60000;
     }
@@ -1276,12 +1284,14 @@ void GCS_MAVLINK::find_next_bucket_to_send(uint16_t now16_ms)
     // all done sending this bucket... find another bucket...
     sending_bucket_id = no_bucket_to_send;
     uint16_t ms_before_send_next_bucket_to_send = UINT16_MAX;
+    // the slowdown is the same for every bucket, only work it out once
+    const uint8_t interval_multiplier = reschedule_interval_multiplier();
     for (uint8_t i=0; i<ARRAY_SIZE(deferred_message_bucket); i++) {
-        if (deferred_message_bucket[i].ap_message_ids.count() == 0) {
+        if (deferred_message_bucket[i].ap_message_ids.empty()) {
             // no entries
             continue;
         }
-        const uint16_t interval = get_reschedule_interval_ms(deferred_message_bucket[i]);
+        const uint16_t interval = get_reschedule_interval_ms(deferred_message_bucket[i], interval_multiplier);
         const uint16_t ms_since_last_sent = now16_ms - deferred_message_bucket[i].last_sent_ms;
         uint16_t ms_before_send_this_bucket;
         if (ms_since_last_sent > interval) {
@@ -1317,8 +1327,15 @@ ap_message GCS_MAVLINK::next_deferred_bucket_message_to_send(uint16_t now16_ms)
         return no_message_to_send;
     }
 
-    const uint16_t ms_since_last_sent = now16_ms - deferred_message_bucket[sending_bucket_id].last_sent_ms;
-    if (ms_since_last_sent < get_reschedule_interval_ms(deferred_message_bucket[sending_bucket_id])) {
+    const deferred_message_bucket_t &bucket = deferred_message_bucket[sending_bucket_id];
+    const uint16_t ms_since_last_sent = now16_ms - bucket.last_sent_ms;
+    // the reschedule interval is never shorter than the bucket's own
+    // interval (short of the 60s cap), so on most calls we can tell
+    // the bucket is not due without working out the slowdowns
+    if (ms_since_last_sent < MIN(bucket.interval_ms, uint16_t(60000))) {
+        return no_message_to_send;
+    }
+    if (ms_since_last_sent < get_reschedule_interval_ms(bucket)) {
         // not time to send this bucket
         return no_message_to_send;
     }
@@ -1640,7 +1657,7 @@ void GCS_MAVLINK::update_send()
                 break;
             }
             bucket_message_ids_to_send.clear(next);
-            if (bucket_message_ids_to_send.count() == 0) {
+            if (bucket_message_ids_to_send.empty()) {
                 // we sent everything in the bucket.  Reschedule it.
                 // we try to keep output on a regular clock to avoid
                 // user support questions:
@@ -1683,7 +1700,7 @@ void GCS_MAVLINK::update_send()
 void GCS_MAVLINK::remove_message_from_bucket(int8_t bucket, ap_message id)
 {
     deferred_message_bucket[bucket].ap_message_ids.clear(id);
-    if (deferred_message_bucket[bucket].ap_message_ids.count() == 0) {
+    if (deferred_message_bucket[bucket].ap_message_ids.empty()) {
         // bucket empty.  Free it:
         deferred_message_bucket[bucket].interval_ms = 0;
         deferred_message_bucket[bucket].last_sent_ms = 0;
@@ -1691,7 +1708,7 @@ void GCS_MAVLINK::remove_message_from_bucket(int8_t bucket, ap_message id)
 
     if (bucket == sending_bucket_id) {
         bucket_message_ids_to_send.clear(id);
-        if (bucket_message_ids_to_send.count() == 0) {
+        if (bucket_message_ids_to_send.empty()) {
             find_next_bucket_to_send(AP_HAL::millis16());
         } else {
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
@@ -1745,7 +1762,7 @@ bool GCS_MAVLINK::set_ap_message_interval(enum ap_message id, uint16_t interval_
                 empty_bucket_id = i;
             }
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
-            if (bucket.ap_message_ids.count() != 0) {
+            if (!bucket.ap_message_ids.empty()) {
                 AP_HAL::panic("Bucket %u has zero interval but with ids set", i);
             }
 #endif
@@ -1780,7 +1797,7 @@ bool GCS_MAVLINK::set_ap_message_interval(enum ap_message id, uint16_t interval_
         // remove from existing bucket
         remove_message_from_bucket(in_bucket, id);
         if (empty_bucket_id == -1 &&
-            deferred_message_bucket[in_bucket].ap_message_ids.count() == 0) {
+            deferred_message_bucket[in_bucket].ap_message_ids.empty()) {
             empty_bucket_id = in_bucket;
         }
     }
@@ -53,6 +53,14 @@ bool GCS_MAVLINK::ftp_init(void) {
         goto failed;
     }
 
+#if AP_MAVLINK_FTP_READ_BUFFER_SIZE > 0
+    // failing to allocate the read-ahead buffer is not fatal, reads
+    // then go straight to the filesystem
+    if (ftp.read_buf == nullptr) {
+        ftp.read_buf = NEW_NOTHROW uint8_t[AP_MAVLINK_FTP_READ_BUFFER_SIZE];
+    }
+#endif
+
     if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&GCS_MAVLINK::ftp_worker, void),
                                       "FTP", 2560, AP_HAL::Scheduler::PRIORITY_IO, 0)) {
         goto failed;
@@ -154,6 +162,43 @@ void GCS_MAVLINK::ftp_error(struct pending_ftp &response, FTP_ERROR error) {
     }
 }
 
+/*
+  read file data at offset from the open file. With a read-ahead
+  buffer, burst reads of small chunks are served from one large
+  filesystem read, which is much cheaper than a seek and read per
+  chunk on SD cards
+ */
+ssize_t GCS_MAVLINK::ftp_read(uint32_t offset, uint8_t *data, uint16_t len)
+{
+#if AP_MAVLINK_FTP_READ_BUFFER_SIZE > 0
+    if (ftp.read_buf != nullptr) {
+        if (offset < ftp.read_buf_offset ||
+            offset + len > ftp.read_buf_offset + ftp.read_buf_len) {
+            // refill the buffer starting at the requested offset
+            ftp.read_buf_len = 0;
+            if (AP::FS().lseek(ftp.fd, offset, SEEK_SET) == -1) {
+                return -1;
+            }
+            const ssize_t read_bytes = AP::FS().read(ftp.fd, ftp.read_buf, AP_MAVLINK_FTP_READ_BUFFER_SIZE);
+            if (read_bytes == -1) {
+                return -1;
+            }
+            ftp.read_buf_offset = offset;
+            ftp.read_buf_len = read_bytes;
+        }
+        const uint16_t ofs = offset - ftp.read_buf_offset;
+        const uint16_t n = MIN(len, ftp.read_buf_len - ofs);
+        memcpy(data, &ftp.read_buf[ofs], n);
+        return n;
+    }
+#endif
+
+    if (AP::FS().lseek(ftp.fd, offset, SEEK_SET) == -1) {
+        return -1;
+    }
+    return AP::FS().read(ftp.fd, data, len);
+}
+
 // send our response back out to the system
 void GCS_MAVLINK::ftp_push_replies(pending_ftp &reply)
 {
@@ -295,6 +340,9 @@ void GCS_MAVLINK::ftp_worker(void) {
                         }
                         ftp.mode = FTP_FILE_MODE::Read;
                         ftp.current_session = request.session;
+#if AP_MAVLINK_FTP_READ_BUFFER_SIZE > 0
+                        ftp.read_buf_len = 0;
+#endif
 
                         reply.opcode = FTP_OP::Ack;
                         reply.size = sizeof(uint32_t);
@@ -320,14 +368,8 @@ void GCS_MAVLINK::ftp_worker(void) {
                             break;
                         }
 
-                        // seek to requested offset
-                        if (AP::FS().lseek(ftp.fd, request.offset, SEEK_SET) == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-
                         // fill the buffer
-                        const ssize_t read_bytes = AP::FS().read(ftp.fd, reply.data, MIN(sizeof(reply.data),request.size));
+                        const ssize_t read_bytes = ftp_read(request.offset, reply.data, MIN(sizeof(reply.data),request.size));
                         if (read_bytes == -1) {
                             ftp_error(reply, FTP_ERROR::FailErrno);
                             break;
@@ -485,12 +527,6 @@ void GCS_MAVLINK::ftp_worker(void) {
                             break;
                         }
 
-                        // seek to requested offset
-                        if (AP::FS().lseek(ftp.fd, request.offset, SEEK_SET) == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-
                         /*
                           calculate a burst delay so that FTP burst
                           transfer doesn't use more than 1/3 of
@@ -513,7 +549,7 @@ void GCS_MAVLINK::ftp_worker(void) {
                         const uint32_t transfer_size = 500;
                         for (uint32_t i = 0; (i < transfer_size); i++) {
                             // fill the buffer
-                            const ssize_t read_bytes = AP::FS().read(ftp.fd, reply.data, MIN(sizeof(reply.data), max_read));
+                            const ssize_t read_bytes = ftp_read(request.offset + i * max_read, reply.data, MIN(sizeof(reply.data), max_read));
                             if (read_bytes == -1) {
                                 ftp_error(reply, FTP_ERROR::FailErrno);
                                 break;
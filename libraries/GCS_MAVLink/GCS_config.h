@@ -86,6 +86,16 @@
 #define AP_MAVLINK_FTP_ENABLED HAL_GCS_ENABLED
 #endif
 
+// size of the read-ahead buffer used to serve FTP file reads, zero
+// to read each chunk directly from the filesystem
+#ifndef AP_MAVLINK_FTP_READ_BUFFER_SIZE
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_500
+#define AP_MAVLINK_FTP_READ_BUFFER_SIZE 4096
+#else
+#define AP_MAVLINK_FTP_READ_BUFFER_SIZE 0
+#endif
+#endif
+
 // GCS should be using MISSION_REQUEST_INT instead; this is a waste of
 // flash.  MISSION_REQUEST was deprecated in June 2020.  We started
 // sending warnings to the GCS in Sep 2022 if MISSION_REQUEST was used.
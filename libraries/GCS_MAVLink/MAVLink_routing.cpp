@@ -32,6 +32,11 @@ extern const AP_HAL::HAL& hal;
 
 #define ROUTING_DEBUG 0
 
+static_assert(MAVLINK_MAX_ROUTES < 255, "route index plus one must fit in route_hash");
+static_assert((MAVLINK_ROUTE_HASH_SIZE & (MAVLINK_ROUTE_HASH_SIZE-1)) == 0, "MAVLINK_ROUTE_HASH_SIZE must be a power of two");
+static_assert(MAVLINK_ROUTE_HASH_SIZE >= 2*MAVLINK_MAX_ROUTES, "MAVLINK_ROUTE_HASH_SIZE too small");
+static_assert(MAVLINK_ROUTE_HASH_SIZE <= 256, "route_hash_slot returns a uint8_t");
+
 // constructor
 MAVLink_routing::MAVLink_routing(void) : num_routes(0) {}
 
@@ -317,7 +322,6 @@ bool MAVLink_routing::find_by_mavtype_and_compid(uint8_t mavtype, uint8_t compid
 */
 void MAVLink_routing::learn_route(GCS_MAVLINK &in_link, const mavlink_message_t &msg)
 {
-    uint8_t i;
     if (msg.sysid == 0) {
         // don't learn routes to the broadcast system
         return;
@@ -335,30 +339,107 @@ void MAVLink_routing::learn_route(GCS_MAVLINK &in_link, const mavlink_message_t
         return;
     }
     const mavlink_channel_t in_channel = in_link.get_chan();
-    for (i=0; i<num_routes; i++) {
-        if (routes[i].sysid == msg.sysid &&
-            routes[i].compid == msg.compid &&
-            routes[i].channel == in_channel) {
-            if (routes[i].mavtype == 0 && msg.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
-                routes[i].mavtype = mavlink_msg_heartbeat_get_type(&msg);
-            }
-            break;
+    const uint32_t now_ms = AP_HAL::millis();
+    const int16_t found = find_route(msg.sysid, msg.compid, in_channel);
+    if (found != -1) {
+        struct route &r = routes[found];
+        r.last_seen_ms = now_ms;
+        if (r.mavtype == 0 && msg.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
+            r.mavtype = mavlink_msg_heartbeat_get_type(&msg);
         }
+        return;
     }
-    if (i == num_routes && i<MAVLINK_MAX_ROUTES) {
-        routes[i].sysid = msg.sysid;
-        routes[i].compid = msg.compid;
-        routes[i].channel = in_channel;
-        if (msg.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
-            routes[i].mavtype = mavlink_msg_heartbeat_get_type(&msg);
+
+    uint8_t i = num_routes;
+    if (i == MAVLINK_MAX_ROUTES) {
+        // table is full. Replace the least recently heard route if it
+        // has gone quiet, otherwise keep the routes we have
+        uint8_t oldest = 0;
+        for (uint8_t j=1; j<num_routes; j++) {
+            if (now_ms - routes[j].last_seen_ms > now_ms - routes[oldest].last_seen_ms) {
+                oldest = j;
+            }
+        }
+        if (now_ms - routes[oldest].last_seen_ms < MAVLINK_ROUTE_EXPIRE_MS) {
+            return;
         }
+        i = oldest;
+    }
+
+    routes[i].sysid = msg.sysid;
+    routes[i].compid = msg.compid;
+    routes[i].channel = in_channel;
+    routes[i].mavtype = 0;
+    if (msg.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
+        routes[i].mavtype = mavlink_msg_heartbeat_get_type(&msg);
+    }
+    routes[i].last_seen_ms = now_ms;
+    if (i == num_routes) {
         num_routes++;
+        hash_route(i);
+    } else {
+        // the replaced route's key is somewhere in the probe
+        // sequences, so start the index again
+        rebuild_route_hash();
+    }
 #if ROUTING_DEBUG
-        ::printf("learned route %u %u via %u\n",
-                 (unsigned)msg.sysid,
-                 (unsigned)msg.compid,
-                 (unsigned)in_channel);
+    ::printf("learned route %u %u via %u\n",
+             (unsigned)msg.sysid,
+             (unsigned)msg.compid,
+             (unsigned)in_channel);
 #endif
+}
+
+/*
+  hash index helpers for the routing table
+*/
+uint8_t MAVLink_routing::route_hash_slot(uint8_t sysid, uint8_t compid, mavlink_channel_t channel)
+{
+    uint32_t h = (uint32_t(sysid) << 16) | (uint32_t(compid) << 8) | uint8_t(channel);
+    // mix the bits so neighbouring component IDs land in different
+    // slots; the caller masks the result to the table size
+    h ^= h >> 16;
+    h *= 0x45d9f3bU;
+    h ^= h >> 16;
+    return h & 0xFF;
+}
+
+int16_t MAVLink_routing::find_route(uint8_t sysid, uint8_t compid, mavlink_channel_t channel) const
+{
+    uint8_t slot = route_hash_slot(sysid, compid, channel);
+    for (uint16_t n=0; n<MAVLINK_ROUTE_HASH_SIZE; n++) {
+        slot &= (MAVLINK_ROUTE_HASH_SIZE-1);
+        const uint8_t entry = route_hash[slot];
+        if (entry == 0) {
+            return -1;
+        }
+        const struct route &r = routes[entry-1];
+        if (r.sysid == sysid && r.compid == compid && r.channel == channel) {
+            return entry-1;
+        }
+        slot++;
+    }
+    return -1;
+}
+
+void MAVLink_routing::hash_route(uint8_t idx)
+{
+    uint8_t slot = route_hash_slot(routes[idx].sysid, routes[idx].compid, routes[idx].channel);
+    for (uint16_t n=0; n<MAVLINK_ROUTE_HASH_SIZE; n++) {
+        slot &= (MAVLINK_ROUTE_HASH_SIZE-1);
+        if (route_hash[slot] == 0) {
+            route_hash[slot] = idx+1;
+            return;
+        }
+        slot++;
+    }
+}
+
+void MAVLink_routing::rebuild_route_hash()
+{
+    memset(route_hash, 0, sizeof(route_hash));
+    for (uint8_t i=0; i<num_routes; i++) {
+        hash_route(i);
     }
 }
 
@@ -5,9 +5,26 @@
 #include <AP_Common/AP_Common.h>
 #include "GCS_MAVLink.h"
 
-// 20 routes should be enough for now. This may need to increase as
-// we make more extensive use of MAVLink forwarding
+// networked vehicles with companions, gimbals, cameras and ADS-B
+// receivers can see many more components than a simple telemetry
+// setup, so allow more routes where memory permits
+#ifndef MAVLINK_MAX_ROUTES
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_500
+#define MAVLINK_MAX_ROUTES 64
+#else
 #define MAVLINK_MAX_ROUTES 20
+#endif
+#endif
+
+// size of the hash index over the routes. Must be a power of two and
+// at least twice MAVLINK_MAX_ROUTES to keep probe sequences short
+#ifndef MAVLINK_ROUTE_HASH_SIZE
+#define MAVLINK_ROUTE_HASH_SIZE (MAVLINK_MAX_ROUTES > 32 ? 128 : 64)
+#endif
+
+// a full table replaces the least recently heard route if it has
+// been silent for this long
+#define MAVLINK_ROUTE_EXPIRE_MS 10000
 
 /*
   object to handle MAVLink packet routing
@@ -50,15 +67,26 @@ public:
     bool find_by_mavtype_and_compid(uint8_t mavtype, uint8_t compid, uint8_t &sysid, mavlink_channel_t &channel) const;
 
 private:
-    // a simple linear routing table. We don't expect to have a lot of
-    // routes, so a scalable structure isn't worthwhile yet.
+    // the routing table. Forwarding walks the whole table as
+    // broadcasts go to every route, but learning a route is done on
+    // every received packet so uses a hash index to find the entry
     uint8_t num_routes;
     struct route {
         uint8_t sysid;
         uint8_t compid;
         mavlink_channel_t channel;
         uint8_t mavtype;
+        uint32_t last_seen_ms;
     } routes[MAVLINK_MAX_ROUTES];
+
+    // open addressed index into routes[] keyed on sysid, compid and
+    // channel. Holds the route index plus one, zero for empty slots
+    uint8_t route_hash[MAVLINK_ROUTE_HASH_SIZE];
+
+    static uint8_t route_hash_slot(uint8_t sysid, uint8_t compid, mavlink_channel_t channel);
+    int16_t find_route(uint8_t sysid, uint8_t compid, mavlink_channel_t channel) const;
+    void hash_route(uint8_t idx);
+    void rebuild_route_hash();
     
     // a channel mask to block routing as required
     uint8_t no_route_mask;
@@ -31,7 +31,6 @@
 #include <AP_BoardConfig/AP_BoardConfig.h>
 #include <AP_JSON/AP_JSON.h>
 #include <AP_Filesystem/AP_Filesystem.h>
-#include <AP_AHRS/AP_AHRS.h>
 #include <AP_HAL_SITL/HAL_SITL_Class.h>
 #include <AP_Vehicle/AP_Vehicle_Type.h>
 
@@ -254,6 +253,10 @@ void Aircraft::time_advance()
         time_now_us += frame_time_us;
     }
     last_time_us = time_now_us;
+#if AP_SIM_LOCKSTEP_ENABLED
+    // don't run ahead of the other vehicles in a lockstep swarm
+    lockstep.step(time_now_us, frame_time_us);
+#endif
     if (use_time_sync) {
         sync_frame_time();
     }
@@ -698,6 +701,19 @@ void Aircraft::update_model(const struct sitl_input &input)
     }
 }
 
+/*
+  step the model without the SITL HAL driving it. Used by programs
+  which construct models directly, such as parameter sweeps that run
+  thousands of models as fast as the CPU allows
+ */
+void Aircraft::step(const struct sitl_input &input, uint32_t num_steps)
+{
+    use_time_sync = false;
+    for (uint32_t i=0; i<num_steps; i++) {
+        update_model(input);
+    }
+}
+
 /*
   update the simulation attitude and relative position
  */
@@ -705,12 +721,6 @@ void Aircraft::update_dynamics(const Vector3f &rot_accel)
 {
     WITH_SEMAPHORE(pose_sem);
 
-    // update eas2tas and air density
-#if AP_AHRS_ENABLED
-    eas2tas = AP::ahrs().get_EAS2TAS();
-#endif
-    air_density = SSL_AIR_DENSITY / sq(eas2tas);
-
     const float delta_time = frame_time_us * 1.0e-6f;
 
     // update eas2tas and air density
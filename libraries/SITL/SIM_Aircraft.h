@@ -38,6 +38,7 @@
 #include "SIM_Battery.h"
 #include <Filter/Filter.h>
 #include "SIM_JSON_Master.h"
+#include "SIM_Lockstep.h"
 #include "ServoModel.h"
 #include "SIM_GPIO_LED_1.h"
 #include "SIM_GPIO_LED_2.h"
@@ -74,6 +75,16 @@ public:
         }
     }
 
+#if AP_SIM_LOCKSTEP_ENABLED
+    /*
+      step on a clock shared with the other num_instances instances
+      of a multi-vehicle simulation. Must be called after set_instance
+     */
+    bool set_lockstep(uint8_t num_instances) {
+        return lockstep.init(instance, num_instances);
+    }
+#endif
+
     /*
       set directory for additional files such as aircraft models
      */
@@ -91,6 +102,15 @@ public:
 
     void update_model(const struct sitl_input &input);
 
+    /*
+      step the model num_steps frames with fixed servo input and no
+      wall clock pacing, for running many models in a tight loop
+     */
+    void step(const struct sitl_input &input, uint32_t num_steps);
+
+    // get simulation time in microseconds
+    uint64_t get_time_now_us(void) const { return time_now_us; }
+
     void update_home();
 
     /* fill a sitl_fdm structure from the simulator state */
@@ -365,6 +385,9 @@ private:
     uint64_t last_time_us;
     uint32_t frame_counter;
     uint32_t last_ground_contact_ms;
+#if AP_SIM_LOCKSTEP_ENABLED
+    Lockstep lockstep;
+#endif
 #if defined(__CYGWIN__) || defined(__CYGWIN64__)
     const uint32_t min_sleep_time{20000};
 #else
@@ -26,6 +26,7 @@
 
 #include <stdio.h>
 #include <sys/stat.h>
+#include <new>
 
 using namespace SITL;
 
@@ -629,6 +630,33 @@ Frame *Frame::find_frame(const char *name)
     return nullptr;
 }
 
+/*
+  allocate a copy of a frame and its motors. Motors and the battery
+  hold per-vehicle state, so each model needs its own copy when more
+  than one model of a frame type runs in the same process
+ */
+Frame *Frame::create_frame(const char *name)
+{
+    const Frame *f = find_frame(name);
+    if (f == nullptr) {
+        return nullptr;
+    }
+    Motor *motors_copy = (Motor *)calloc(f->num_motors, sizeof(Motor));
+    if (motors_copy == nullptr) {
+        return nullptr;
+    }
+    for (uint8_t i=0; i<f->num_motors; i++) {
+        new (&motors_copy[i]) Motor(f->motors[i]);
+    }
+    Frame *ret = NEW_NOTHROW Frame(*f);
+    if (ret == nullptr) {
+        free(motors_copy);
+        return nullptr;
+    }
+    ret->motors = motors_copy;
+    return ret;
+}
+
 // calculate rotational and linear accelerations
 void Frame::calculate_forces(const Aircraft &aircraft,
                              const struct sitl_input &input,
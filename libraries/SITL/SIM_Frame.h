@@ -47,6 +47,9 @@ public:
 #if AP_SIM_ENABLED
     // find a frame by name
     static Frame *find_frame(const char *name);
+
+    // allocate a private copy of a frame by name
+    static Frame *create_frame(const char *name);
     
     // initialise frame
     void init(const char *frame_str, Battery *_battery);
@@ -0,0 +1,161 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  shared simulation clock for running several SITL instances in lockstep
+*/
+
+#include "SIM_Lockstep.h"
+
+#if AP_SIM_LOCKSTEP_ENABLED
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace SITL;
+
+// monotonic wall clock, common to all processes on the host
+static uint64_t lockstep_wall_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec)*1000000ULL + ts.tv_nsec/1000U;
+}
+
+/*
+  map the shared clock file. All instances of a swarm must use the
+  same file, which defaults to one per user in /tmp and can be
+  changed with the SITL_LOCKSTEP_FILE environment variable to run
+  several independent swarms on one host
+ */
+bool Lockstep::init(uint8_t instance, uint8_t _num_instances)
+{
+    if (_num_instances < 2 || _num_instances > MAX_INSTANCES || instance >= _num_instances) {
+        ::fprintf(stderr, "Lockstep: instance %u not in 0..%u\n", unsigned(instance), unsigned(_num_instances));
+        return false;
+    }
+
+    char path[64];
+    const char *env_path = getenv("SITL_LOCKSTEP_FILE");
+    if (env_path != nullptr) {
+        strncpy(path, env_path, sizeof(path)-1);
+        path[sizeof(path)-1] = 0;
+    } else {
+        snprintf(path, sizeof(path), "/tmp/ap_sitl_lockstep_%u.dat", unsigned(getuid()));
+    }
+
+    const int fd = ::open(path, O_RDWR|O_CREAT|O_CLOEXEC, 0600);
+    if (fd == -1) {
+        ::fprintf(stderr, "Lockstep: open(%s) failed: %s\n", path, strerror(errno));
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::fprintf(stderr, "Lockstep: fstat(%s) failed: %s\n", path, strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    const bool size_ok = st.st_size == off_t(sizeof(struct shared_clock));
+    if (!size_ok && ftruncate(fd, sizeof(struct shared_clock)) != 0) {
+        ::fprintf(stderr, "Lockstep: ftruncate(%s) failed: %s\n", path, strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    void *p = mmap(nullptr, sizeof(struct shared_clock), PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        ::fprintf(stderr, "Lockstep: mmap(%s) failed: %s\n", path, strerror(errno));
+        return false;
+    }
+    clock = (struct shared_clock *)p;
+    our_instance = instance;
+    num_instances = _num_instances;
+
+    // only trust the other entries if the file was already laid out
+    // by a matching build, otherwise start from an empty clock. Valid
+    // entries left over from a previous run will be stale and so
+    // ignored
+    if (!size_ok || __atomic_load_n(&clock->magic, __ATOMIC_ACQUIRE) != MAGIC) {
+        memset((void *)clock, 0, sizeof(struct shared_clock));
+    }
+
+    // clear our own entry so we start from a clean slate
+    __atomic_store_n(&clock->instance[our_instance].time_us, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&clock->instance[our_instance].wall_us, lockstep_wall_us(), __ATOMIC_RELEASE);
+    __atomic_store_n(&clock->magic, MAGIC, __ATOMIC_RELEASE);
+
+    ::printf("Lockstep: instance %u of %u using %s\n", unsigned(instance), unsigned(num_instances), path);
+    return true;
+}
+
+/*
+  publish our time and block until no live instance is more than one
+  frame behind us. The instance furthest behind never waits, so the
+  swarm always makes progress
+ */
+void Lockstep::step(uint64_t time_now_us, uint64_t frame_time_us)
+{
+    if (clock == nullptr) {
+        return;
+    }
+
+    auto &us = clock->instance[our_instance];
+    __atomic_store_n(&us.time_us, time_now_us, __ATOMIC_RELEASE);
+
+    uint32_t spins = 0;
+    while (true) {
+        const uint64_t now_us = lockstep_wall_us();
+        __atomic_store_n(&us.wall_us, now_us, __ATOMIC_RELEASE);
+
+        bool waiting = false;
+        for (uint8_t i=0; i<num_instances; i++) {
+            if (i == our_instance) {
+                continue;
+            }
+            const auto &other = clock->instance[i];
+            const uint64_t wall_us = __atomic_load_n(&other.wall_us, __ATOMIC_ACQUIRE);
+            if (wall_us == 0 || now_us > wall_us + STALE_US) {
+                // not started yet, exited or stopped
+                continue;
+            }
+            if (__atomic_load_n(&other.time_us, __ATOMIC_ACQUIRE) + frame_time_us < time_now_us) {
+                waiting = true;
+                break;
+            }
+        }
+        if (!waiting) {
+            return;
+        }
+
+        // the others normally catch up within a few microseconds, so
+        // yield the core to them first and only sleep if they are
+        // slow, to avoid burning CPU when there are more instances
+        // than cores
+        if (spins++ < 100) {
+            sched_yield();
+        } else {
+            usleep(100);
+        }
+    }
+}
+
+#endif  // AP_SIM_LOCKSTEP_ENABLED
@@ -0,0 +1,72 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  shared simulation clock for running several SITL instances in
+  lockstep. Each instance publishes its simulation time in a small
+  shared memory file and will not step past the slowest live
+  instance by more than one frame. This keeps multi-vehicle tests
+  deterministic while letting them run as fast as the host allows
+*/
+
+#pragma once
+
+#include "SIM_config.h"
+
+#if AP_SIM_LOCKSTEP_ENABLED
+
+#include <stdint.h>
+
+namespace SITL {
+
+class Lockstep {
+public:
+    Lockstep() {}
+
+    // map the shared clock for num_instances instances, instance
+    // being our index within them
+    bool init(uint8_t instance, uint8_t num_instances);
+
+    // publish our simulation time and wait until all other live
+    // instances are within one frame of it
+    void step(uint64_t time_now_us, uint64_t frame_time_us);
+
+    static const uint8_t MAX_INSTANCES = 16;
+
+private:
+    // marks a file laid out as a shared_clock. Change it if the
+    // layout changes so a file left by an older build is reset
+    static const uint32_t MAGIC = 0x4c4b5354;
+
+    // an instance which has not updated its entry for this long
+    // (wall clock) is assumed to have exited or be stopped in a
+    // debugger and is no longer waited for
+    static const uint32_t STALE_US = 2000000;
+
+    struct shared_clock {
+        uint32_t magic;
+        struct {
+            uint64_t time_us;
+            uint64_t wall_us;
+        } instance[MAX_INSTANCES];
+    };
+
+    struct shared_clock *clock;
+    uint8_t our_instance;
+    uint8_t num_instances;
+};
+
+}
+
+#endif  // AP_SIM_LOCKSTEP_ENABLED
@@ -293,6 +293,10 @@
 #define AP_SIM_JSON_MASTER_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_SITL)
 #endif  // AP_SIM_JSON_MASTER_ENABLED
 
+#ifndef AP_SIM_LOCKSTEP_ENABLED
+#define AP_SIM_LOCKSTEP_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_SITL)
+#endif  // AP_SIM_LOCKSTEP_ENABLED
+
 #ifndef AP_SIM_LAST_LETTER_ENABLED
 #define AP_SIM_LAST_LETTER_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_SITL)
 #endif  // AP_SIM_LAST_LETTER_ENABLED
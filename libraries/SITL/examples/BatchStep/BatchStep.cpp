@@ -0,0 +1,100 @@
+#include <AP_HAL/AP_HAL.h>
+
+#include <SITL/SITL.h>
+#include <SITL/SIM_Multicopter.h>
+#include <SITL/SITL_Input.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+  step many multicopter models directly, with no sockets, scheduler
+  or wall clock pacing. Each model flies a simple altitude hold with
+  a different gain, and the RMS altitude error is printed for each.
+
+  run with:
+    ./waf configure --board sitl
+    ./waf build --targets examples/BatchStep
+    ./build/sitl/examples/BatchStep quad 64 20
+*/
+
+void setup();
+void loop();
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// models read the SIM_ parameters
+SITL::SIM sim;
+
+void setup(void)
+{
+    uint8_t argc;
+    char * const *argv;
+
+    hal.util->commandline_arguments(argc, argv);
+
+    if (argc <= 3) {
+        ::printf("pass frame type, number of models and seconds to simulate\n");
+        exit(0);
+    }
+
+    const char *frame_str = argv[1];
+    const uint16_t num_models = MAX(atoi(argv[2]), 1);
+    const float duration_s = strtof(argv[3], nullptr);
+
+    SITL::Aircraft **models = NEW_NOTHROW SITL::Aircraft*[num_models];
+    float *sum_sq_err = NEW_NOTHROW float[num_models];
+    if (models == nullptr || sum_sq_err == nullptr) {
+        ::printf("out of memory\n");
+        exit(1);
+    }
+    const Location home {-353632610, 1491652300, 58400, Location::AltFrame::ABSOLUTE};
+    for (uint16_t i=0; i<num_models; i++) {
+        models[i] = SITL::MultiCopter::create(frame_str);
+        models[i]->set_start_location(home, 0);
+        sum_sq_err[i] = 0;
+    }
+
+    // step the physics in blocks of 10 frames, running the controller
+    // between blocks as a vehicle's main loop would
+    const uint32_t steps_per_update = 10;
+    const float target_alt_m = 10;
+    const float hover_pwm = 1500;
+    const float dt = steps_per_update / models[0]->get_rate_hz();
+    const uint32_t num_updates = duration_s / dt;
+
+    const uint64_t start_us = AP_HAL::micros64();
+    for (uint32_t n=0; n<num_updates; n++) {
+        for (uint16_t i=0; i<num_models; i++) {
+            SITL::Aircraft &model = *models[i];
+
+            // altitude gain swept across the models
+            const float kp = 10.0 + 190.0 * i / num_models;
+            const float kd = 100.0;
+            const float alt_err = target_alt_m + model.get_position_relhome().z;
+            const float pwm = hover_pwm + kp * alt_err + kd * model.get_velocity_ef().z;
+
+            struct sitl_input input {};
+            for (uint8_t s=0; s<ARRAY_SIZE(input.servos); s++) {
+                input.servos[s] = constrain_float(pwm, 1000, 2000);
+            }
+            model.step(input, steps_per_update);
+
+            sum_sq_err[i] += sq(alt_err);
+        }
+    }
+    const float elapsed_s = (AP_HAL::micros64() - start_us) * 1.0e-6;
+
+    ::printf("kp, rms_alt_err\n");
+    for (uint16_t i=0; i<num_models; i++) {
+        ::printf("%.1f, %.3f\n", 10.0 + 190.0 * i / num_models, sqrtf(sum_sq_err[i] / MAX(num_updates, 1U)));
+    }
+    ::printf("simulated %u models for %.1fs in %.2fs\n", unsigned(num_models), duration_s, elapsed_s);
+}
+
+void loop(void)
+{
+    exit(0);
+}
+
+AP_HAL_MAIN();